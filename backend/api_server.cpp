@@ -0,0 +1,621 @@
+// Long-lived maze service for server/server.js.
+//
+// The Node server starts this once and keeps it running, so generated
+// mazes and their search tables stay warm between requests and nobody
+// pays process startup per call. Requests and responses are frames on
+// stdin/stdout:
+//
+//   uint32 payload length (little endian) | uint8 encoding | payload
+//
+// with encoding 0 = JSON, 1 = MessagePack (answered in the same encoding),
+// 2 = packed maze, 3 = packed batch results or 4 = packed bracket. The last
+// three are responses only: a u32 request id, then the bytes of
+// MazeEnvironment::toPacked, BatchResults::toPacked or Bracket::toPacked.
+// Every request carries an "id" that is echoed in its response; requests
+// run concurrently on a worker pool, so responses may come back in any
+// order.
+//
+//   {"id": 1, "op": "ping"}
+//   {"id": 2, "op": "maze", "rows": 50, "cols": 50, "seed": 7 | "7",
+//    "generator": "spanning_tree", "wall_density": 0.5, "loop_density": 0.1,
+//    "format": "json" | "packed"}
+//   {"id": 3, "op": "solve", <maze fields or "grid": [[...]]>,
+//    "mode": "bfs" | "astar" | "flood"}
+//   {"id": 4, "op": "tournament", "players": ["a", "b"], <maze fields>,
+//    "search": "alpha_beta" | "negamax" | "distance_field", "threads": 0,
+//    "max_steps": 0, "time_limit_ms": 0, "search_depth": 3, "move_nodes": 0,
+//    "move_time_us": 0, "stream": false}
+//   {"id": 5, "op": "batch", "seeds": [1, 2, 3], "size": 20 | [..],
+//    "rows": .., "cols": .., "players": 4 | [..], <generator fields>,
+//    "search": .., "threads": 0, "max_steps": 0, "time_limit_ms": 0,
+//    "search_depth": 3, "move_nodes": 0, "move_time_us": 0,
+//    "format": "json" | "packed"}
+//   {"id": 6, "op": "bracket", "players": ["a", "b", "c"],
+//    "format": "json" | "packed"}  (packed also takes "entrants": 3)
+//   {"id": 7, "op": "bracket_open", "entrants": 3}
+//   {"id": 8, "op": "bracket_result", "bracket_id": 1, "match": 2,
+//    "winner": 3}
+//   {"id": 9, "op": "bracket_close", "bracket_id": 1}
+//   {"id": 10, "op": "stats"}
+//
+// Responses are {"id": n, "ok": true, "result": ...} or
+// {"id": n, "ok": false, "error": "..."}. A streamed tournament first sends
+// one {"id": n, "ok": true, "partial": true, "result": {"name": ..., ...}}
+// per player as it finishes, then a final response with the seed and the
+// player count but no per-player table. A batch runs one match per seed and
+// player, with rows/cols/size/players either shared or given per seed, and
+// answers with one array per column (see maze_batch.hpp). A bracket seeds
+// the players in the order given, best first, and has the layout of
+// generateBracket in server.js. A live bracket (bracket_open) starts with
+// only the byes decided and stays in the service, so "bracket" can fetch it
+// by "bracket_id"; each bracket_result (a winner seed, or null to clear a
+// result) answers with just the matches whose outcome changed and the
+// bracket's new version. At most MAX_LIVE_BRACKETS stay open; past that,
+// opening one closes the least recently used.
+
+#include "maze_environment.hpp"
+#include "bracket_generator.hpp"
+#include "maze_batch.hpp"
+#include "maze_solver.hpp"
+#include "match_arena.hpp"
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+enum FrameEncoding : uint8_t {
+    FRAME_JSON = 0,
+    FRAME_MSGPACK = 1,
+    FRAME_PACKED_MAZE = 2,
+    FRAME_BATCH_RESULTS = 3,
+    FRAME_PACKED_BRACKET = 4
+};
+
+const uint32_t MAX_FRAME_BYTES = 256u << 20;
+const size_t MAZE_CACHE_ENTRIES = 64;
+const size_t MAZE_CACHE_BYTES = size_t(512) << 20;
+const size_t MAX_LIVE_BRACKETS = 256;
+
+// --- Framing ---
+
+bool readExact(void* buffer, size_t size) {
+    return fread(buffer, 1, size, stdin) == size;
+}
+
+// Returns false on a clean EOF between frames
+bool readFrame(FrameEncoding& encoding, string& payload) {
+    uint8_t header[5];
+    if (!readExact(header, sizeof(header))) {
+        return false;
+    }
+    uint32_t length = uint32_t(header[0]) | (uint32_t(header[1]) << 8) |
+                      (uint32_t(header[2]) << 16) | (uint32_t(header[3]) << 24);
+    if (length > MAX_FRAME_BYTES) {
+        throw runtime_error("Frame of " + to_string(length) + " bytes exceeds the limit");
+    }
+    encoding = FrameEncoding(header[4]);
+    payload.resize(length);
+    if (length > 0 && !readExact(&payload[0], length)) {
+        throw runtime_error("Truncated frame");
+    }
+    return true;
+}
+
+mutex outputMutex;
+
+template <typename Bytes>
+void writeFrame(FrameEncoding encoding, const Bytes& payload) {
+    uint32_t length = uint32_t(payload.size());
+    uint8_t header[5] = {uint8_t(length), uint8_t(length >> 8), uint8_t(length >> 16),
+                         uint8_t(length >> 24), uint8_t(encoding)};
+    lock_guard<mutex> lock(outputMutex);
+    fwrite(header, 1, sizeof(header), stdout);
+    fwrite(payload.data(), 1, payload.size(), stdout);
+    fflush(stdout);
+}
+
+// --- Worker pool ---
+
+// Fixed set of threads pulling jobs from a queue; the destructor finishes
+// every queued job before joining
+class TaskPool {
+public:
+    explicit TaskPool(size_t threadCount) {
+        for (size_t i = 0; i < max<size_t>(threadCount, 1); i++) {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void submit(function<void()> job) {
+        {
+            lock_guard<mutex> lock(queueMutex);
+            jobs.push_back(move(job));
+        }
+        ready.notify_one();
+    }
+
+private:
+    vector<thread> workers;
+    deque<function<void()>> jobs;
+    mutex queueMutex;
+    condition_variable ready;
+    bool stopping = false;
+
+    void run() {
+        while (true) {
+            function<void()> job;
+            {
+                unique_lock<mutex> lock(queueMutex);
+                ready.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (jobs.empty()) {
+                    return;
+                }
+                job = move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+// --- Maze cache ---
+
+// Least-recently-used cache of generated mazes keyed by everything that
+// determines them. Entries are shared and immutable (apart from the
+// thread-safe search table), so requests keep using a maze even if it is
+// evicted meanwhile. The cache is bounded by entries and by the bytes
+// they hold (footprintBytes); a maze bigger than the byte budget on its
+// own is handed out without being cached.
+class MazeCache {
+public:
+    MazeCache(size_t capacity, size_t byteBudget) : capacity(capacity), byteBudget(byteBudget) {}
+
+    shared_ptr<const MazeEnvironment> get(int rows, int cols, uint64_t seed, const MazeParams& params) {
+        char key[128];
+        snprintf(key, sizeof(key), "%d:%d:%llu:%d:%a:%a", rows, cols, (unsigned long long)seed,
+                 int(params.generator), params.wallDensity, params.loopDensity);
+        {
+            lock_guard<mutex> lock(cacheMutex);
+            auto found = index.find(key);
+            if (found != index.end()) {
+                hits++;
+                entries.splice(entries.begin(), entries, found->second);
+                return found->second->env;
+            }
+            misses++;
+        }
+
+        // Generate outside the lock; if two requests race on the same key
+        // the second insert just finds the first one's entry
+        auto env = make_shared<const MazeEnvironment>(rows, cols, seed, params);
+        size_t bytes = env->footprintBytes();
+        lock_guard<mutex> lock(cacheMutex);
+        auto found = index.find(key);
+        if (found != index.end()) {
+            return found->second->env;
+        }
+        if (bytes > byteBudget) {
+            return env;
+        }
+        entries.push_front({key, env, bytes});
+        index[key] = entries.begin();
+        totalBytes += bytes;
+        while (entries.size() > capacity || totalBytes > byteBudget) {
+            totalBytes -= entries.back().bytes;
+            index.erase(entries.back().key);
+            entries.pop_back();
+        }
+        return env;
+    }
+
+    json stats() {
+        lock_guard<mutex> lock(cacheMutex);
+        return {{"entries", entries.size()}, {"bytes", totalBytes}, {"hits", hits}, {"misses", misses}};
+    }
+
+private:
+    struct Entry {
+        string key;
+        shared_ptr<const MazeEnvironment> env;
+        size_t bytes;
+    };
+
+    size_t capacity;
+    size_t byteBudget;
+    size_t totalBytes = 0;
+    list<Entry> entries; // most recently used first
+    unordered_map<string, list<Entry>::iterator> index;
+    uint64_t hits = 0, misses = 0;
+    mutex cacheMutex;
+};
+
+// --- Live brackets ---
+
+// Brackets kept open while their results are reported. Each has its own
+// lock, so results for different brackets apply concurrently. Clients that
+// never close theirs cannot lock everyone else out: once the table is full,
+// opening a bracket evicts the one used least recently.
+class LiveBrackets {
+public:
+    struct Entry {
+        mutex lock;
+        Bracket bracket;
+
+        explicit Entry(size_t entrants) : bracket(entrants) {}
+    };
+
+    uint64_t open(size_t entrants) {
+        auto entry = make_shared<Entry>(entrants);
+        lock_guard<mutex> lock(bracketsMutex);
+        if (brackets.size() >= MAX_LIVE_BRACKETS) {
+            auto oldest = min_element(brackets.begin(), brackets.end(), [](const auto& a, const auto& b) {
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            brackets.erase(oldest);
+        }
+        uint64_t id = nextId++;
+        brackets[id] = {entry, useCounter++};
+        return id;
+    }
+
+    shared_ptr<Entry> get(uint64_t id) {
+        lock_guard<mutex> lock(bracketsMutex);
+        auto found = brackets.find(id);
+        if (found == brackets.end()) {
+            throw invalid_argument("No live bracket " + to_string(id));
+        }
+        found->second.lastUsed = useCounter++;
+        return found->second.entry;
+    }
+
+    void close(uint64_t id) {
+        lock_guard<mutex> lock(bracketsMutex);
+        if (brackets.erase(id) == 0) {
+            throw invalid_argument("No live bracket " + to_string(id));
+        }
+    }
+
+    size_t size() {
+        lock_guard<mutex> lock(bracketsMutex);
+        return brackets.size();
+    }
+
+private:
+    struct Slot {
+        shared_ptr<Entry> entry;
+        uint64_t lastUsed; // useCounter at the last open or get
+    };
+
+    unordered_map<uint64_t, Slot> brackets;
+    uint64_t nextId = 1;
+    uint64_t useCounter = 0;
+    mutex bracketsMutex;
+};
+
+MazeCache mazeCache(MAZE_CACHE_ENTRIES, MAZE_CACHE_BYTES);
+LiveBrackets liveBrackets;
+atomic<uint64_t> requestsServed(0);
+
+// --- Request handlers ---
+
+MazeParams paramsFromRequest(const json& request) {
+    MazeParams params;
+    if (request.contains("generator")) {
+        params.generator = parseGenerator(request["generator"].get<string>());
+    }
+    params.wallDensity = request.value("wall_density", params.wallDensity);
+    params.loopDensity = request.value("loop_density", params.loopDensity);
+    return params;
+}
+
+// A seed is a JSON number or a decimal string. JavaScript numbers are
+// doubles, so a client holding a seed above 2^53 has to send the string.
+uint64_t seedFromJson(const json& value) {
+    if (!value.is_string()) {
+        return value.get<uint64_t>();
+    }
+    const string& text = value.get_ref<const string&>();
+    size_t used = 0;
+    uint64_t seed = 0;
+    if (!text.empty() && isdigit(static_cast<unsigned char>(text[0]))) {
+        try {
+            seed = stoull(text, &used);
+        } catch (const out_of_range&) {
+            used = 0;
+        }
+    }
+    if (used == 0 || used != text.size()) {
+        throw invalid_argument("seed must be an unsigned 64-bit integer");
+    }
+    return seed;
+}
+
+// A literal "grid" is used as is; otherwise the maze is generated from
+// its fields and cached when it has a seed (unseeded mazes are one-off)
+shared_ptr<const MazeEnvironment> mazeFromRequest(const json& request) {
+    if (request.contains("grid")) {
+        return make_shared<const MazeEnvironment>(request["grid"].get<vector<vector<int>>>());
+    }
+    int rows = request.value("rows", request.value("size", MAZE_SIZE));
+    int cols = request.value("cols", request.value("size", MAZE_SIZE));
+    MazeParams params = paramsFromRequest(request);
+    if (!request.contains("seed")) {
+        return make_shared<const MazeEnvironment>(rows, cols, MazeEnvironment::randomSeed(), params);
+    }
+    return mazeCache.get(rows, cols, seedFromJson(request["seed"]), params);
+}
+
+json handleSolve(const json& request) {
+    auto env = mazeFromRequest(request);
+    SolverMode mode = parseSolverMode(request.value("mode", "bfs"));
+    MatchArena& arena = MatchArena::forThisThread();
+    arena.reset();
+    MazeSolver solver(*env, &arena);
+    return solutionToNodeJson(solver.solve(mode));
+}
+
+// Sends a partial response ahead of the final one
+using PartialSender = function<void(const json&)>;
+
+PlayLimits limitsFromRequest(const json& request) {
+    PlayLimits limits;
+    limits.maxSteps = request.value("max_steps", 0LL);
+    limits.timeLimit = chrono::milliseconds(request.value("time_limit_ms", 0LL));
+    limits.searchDepth = request.value("search_depth", limits.searchDepth);
+    limits.moveNodes = request.value("move_nodes", uint64_t(0));
+    limits.moveTime = chrono::microseconds(request.value("move_time_us", 0LL));
+    // playMaze checks too, but on a worker thread a throw would end the process
+    if (limits.searchDepth < 1 || limits.searchDepth > MAX_SEARCH_DEPTH) {
+        throw invalid_argument("search_depth must be between 1 and " + to_string(MAX_SEARCH_DEPTH));
+    }
+    return limits;
+}
+
+// Every request spawns its own workers, so more than the machine has only
+// adds threads; 0 (or less) asks for one per hardware thread
+int threadsFromRequest(const json& request) {
+    int hardware = int(max(1u, thread::hardware_concurrency()));
+    int threads = request.value("threads", 0);
+    return threads <= 0 ? hardware : min(threads, hardware);
+}
+
+json handleTournament(const json& request, const PartialSender& sendPartial) {
+    auto env = mazeFromRequest(request);
+    TournamentOptions options;
+    options.mode = parseSearchMode(request.value("search", "alpha_beta"));
+    options.threads = threadsFromRequest(request);
+    options.limits = limitsFromRequest(request);
+    vector<string> players = request.at("players").get<vector<string>>();
+    json result;
+    result["seed"] = env->getSeed();
+    if (request.value("stream", false)) {
+        streamMazeTournament(players, *env, options, [&](const PlayerResult& player) {
+            json record = playerResultJson(player);
+            record["name"] = player.name;
+            sendPartial(record);
+        });
+        result["players"] = players.size();
+    } else {
+        result["players"] = runMazeTournament(players, *env, options);
+    }
+    return result;
+}
+
+// A per-job field is either one number shared by every job or an array
+// with one entry per seed
+int batchField(const json& request, const char* key, size_t job, int fallback) {
+    if (!request.contains(key)) {
+        return fallback;
+    }
+    const json& value = request[key];
+    return value.is_array() ? value.at(job).get<int>() : value.get<int>();
+}
+
+BatchResults runBatchRequest(const json& request) {
+    const json& seeds = request.at("seeds");
+    MazeBatch batch;
+    for (size_t job = 0; job < seeds.size(); job++) {
+        int size = batchField(request, "size", job, MAZE_SIZE);
+        batch.add(seedFromJson(seeds[job]), batchField(request, "rows", job, size),
+                  batchField(request, "cols", job, size), batchField(request, "players", job, 1));
+    }
+    BatchOptions options;
+    options.mode = parseSearchMode(request.value("search", "alpha_beta"));
+    options.threads = threadsFromRequest(request);
+    options.params = paramsFromRequest(request);
+    options.limits = limitsFromRequest(request);
+    return runMazeBatch(batch, options);
+}
+
+json handleBatch(const json& request) {
+    BatchResults results = runBatchRequest(request);
+    json termination = json::array();
+    for (uint8_t reason : results.termination) {
+        termination.push_back(terminationName(TerminationReason(reason)));
+    }
+    return {{"first_player", results.firstPlayer},
+            {"total_reward", results.totalReward},
+            {"steps", results.steps},
+            {"revisits", results.revisits},
+            {"search_nodes", results.searchNodes},
+            {"termination", termination}};
+}
+
+// A packed bracket only needs the player count ("entrants" instead of
+// "players" spares sending the names), since the client has the names.
+// With a "bracket_id" it is a snapshot of that live bracket.
+Bracket bracketFromRequest(const json& request) {
+    if (request.contains("bracket_id")) {
+        auto entry = liveBrackets.get(request["bracket_id"].get<uint64_t>());
+        lock_guard<mutex> lock(entry->lock);
+        return entry->bracket;
+    }
+    Bracket bracket(request.contains("entrants") ? request["entrants"].get<size_t>()
+                                                 : request.at("players").size());
+    bracket.decideBySeed();
+    return bracket;
+}
+
+json handleBracket(const json& request) {
+    return bracketFromRequest(request).toJson(request.at("players").get<vector<string>>());
+}
+
+json handleBracketOpen(const json& request) {
+    size_t entrants = request.contains("entrants") ? request["entrants"].get<size_t>()
+                                                   : request.at("players").size();
+    return {{"bracket_id", liveBrackets.open(entrants)}, {"entrants", entrants}, {"version", 0}};
+}
+
+json handleBracketResult(const json& request) {
+    auto entry = liveBrackets.get(request.at("bracket_id").get<uint64_t>());
+    uint32_t match = request.at("match").get<uint32_t>();
+    const json& winner = request.at("winner");
+    lock_guard<mutex> lock(entry->lock);
+    vector<BracketChange> changes =
+        entry->bracket.reportResult(match, winner.is_null() ? Bracket::NO_SEED : winner.get<uint32_t>());
+    json changeList = json::array();
+    for (const BracketChange& change : changes) {
+        changeList.push_back({{"match", change.match},
+                              {"round", entry->bracket.roundOf(change.match)},
+                              {"winner", change.seed == Bracket::NO_SEED ? json() : json(change.seed)}});
+    }
+    return {{"version", entry->bracket.getVersion()}, {"changes", changeList}};
+}
+
+json handleRequest(const json& request, const PartialSender& sendPartial) {
+    string op = request.at("op").get<string>();
+    if (op == "ping") {
+        return {{"pong", true}};
+    }
+    if (op == "maze") {
+        return mazeFromRequest(request)->getMazeState();
+    }
+    if (op == "solve") {
+        return handleSolve(request);
+    }
+    if (op == "tournament") {
+        return handleTournament(request, sendPartial);
+    }
+    if (op == "batch") {
+        return handleBatch(request);
+    }
+    if (op == "bracket") {
+        return handleBracket(request);
+    }
+    if (op == "bracket_open") {
+        return handleBracketOpen(request);
+    }
+    if (op == "bracket_result") {
+        return handleBracketResult(request);
+    }
+    if (op == "bracket_close") {
+        liveBrackets.close(request.at("bracket_id").get<uint64_t>());
+        return {{"closed", true}};
+    }
+    if (op == "stats") {
+        return {{"requests", requestsServed.load()},
+                {"maze_cache", mazeCache.stats()},
+                {"live_brackets", liveBrackets.size()}};
+    }
+    throw invalid_argument("Unknown op: " + op);
+}
+
+// Packed mazes, batch results and brackets skip the JSON DOM entirely: the
+// frame is the request id followed by the packed bytes
+bool servePacked(const json& request) {
+    if (request.value("format", "json") != "packed") {
+        return false;
+    }
+    FrameEncoding encoding;
+    vector<uint8_t> packed;
+    if (request.at("op") == "maze") {
+        encoding = FRAME_PACKED_MAZE;
+        packed = mazeFromRequest(request)->toPacked();
+    } else if (request.at("op") == "batch") {
+        encoding = FRAME_BATCH_RESULTS;
+        packed = runBatchRequest(request).toPacked();
+    } else if (request.at("op") == "bracket") {
+        encoding = FRAME_PACKED_BRACKET;
+        packed = bracketFromRequest(request).toPacked();
+    } else {
+        return false;
+    }
+    uint32_t id = request.at("id").get<uint32_t>();
+    vector<uint8_t> payload = {uint8_t(id), uint8_t(id >> 8), uint8_t(id >> 16), uint8_t(id >> 24)};
+    payload.insert(payload.end(), packed.begin(), packed.end());
+    writeFrame(encoding, payload);
+    return true;
+}
+
+void writeResponse(FrameEncoding encoding, const json& response) {
+    if (encoding == FRAME_MSGPACK) {
+        writeFrame(FRAME_MSGPACK, json::to_msgpack(response));
+    } else {
+        writeFrame(FRAME_JSON, response.dump());
+    }
+}
+
+void serve(FrameEncoding encoding, const string& payload) {
+    json response;
+    try {
+        json request = encoding == FRAME_MSGPACK ? json::from_msgpack(payload) : json::parse(payload);
+        response["id"] = request.value("id", json());
+        if (servePacked(request)) {
+            requestsServed++;
+            return;
+        }
+        auto sendPartial = [&](const json& result) {
+            writeResponse(encoding, {{"id", response["id"]}, {"ok", true}, {"partial", true}, {"result", result}});
+        };
+        response["result"] = handleRequest(request, sendPartial);
+        response["ok"] = true;
+    } catch (const exception& error) {
+        response["ok"] = false;
+        response["error"] = error.what();
+    }
+    requestsServed++;
+    writeResponse(encoding, response);
+}
+
+int main() {
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    TaskPool pool(thread::hardware_concurrency());
+    try {
+        FrameEncoding encoding;
+        string payload;
+        while (readFrame(encoding, payload)) {
+            if (encoding != FRAME_JSON && encoding != FRAME_MSGPACK) {
+                writeFrame(FRAME_JSON, json{{"ok", false}, {"error", "Unsupported frame encoding"}}.dump());
+                continue;
+            }
+            pool.submit([encoding, payload]() { serve(encoding, payload); });
+        }
+    } catch (const exception& error) {
+        // A broken stream cannot be resynchronised; finish queued work and exit
+        cerr << "api_server: " << error.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include "bracket_generator.hpp"
+
+namespace {
+
+uint32_t reverseBits(uint32_t x) {
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+uint32_t lowBits(int count) {
+    return count >= 32 ? ~0u : (1u << count) - 1;
+}
+
+} // namespace
+
+Bracket::Bracket(size_t entrantCount) : entrants(uint32_t(entrantCount)), slots(1), rounds(0) {
+    if (entrantCount < MIN_BRACKET_ENTRANTS || entrantCount > MAX_BRACKET_ENTRANTS) {
+        throw invalid_argument("A bracket needs between " + to_string(MIN_BRACKET_ENTRANTS) +
+                               " and " + to_string(MAX_BRACKET_ENTRANTS) + " entrants");
+    }
+    while (slots < entrants) {
+        slots <<= 1;
+        rounds++;
+    }
+    nodes.assign(size_t(2) * slots, NO_SEED);
+    for (uint32_t line = 0; line < slots; line++) {
+        nodes[slots + line] = seedAt(line, rounds);
+    }
+    // The better seed of a first-round pair is always on the even line, so
+    // only the odd line can be a bye
+    for (uint32_t match = slots / 2; match < slots; match++) {
+        if (isBye(nodes[2 * match + 1])) {
+            nodes[match] = nodes[2 * match];
+        }
+    }
+}
+
+// Building the order for 2L lines from the one for L puts each seed s at
+// twice its old line and its round-1 opponent 2L + 1 - s right after it.
+// Unrolled over the bits of the line, seed - 1 is the bit reversal of the
+// running XOR of the line's bits from the lowest up.
+uint32_t Bracket::seedAt(uint32_t line, int rounds) {
+    if (rounds == 0) {
+        return 1;
+    }
+    uint32_t prefix = line;
+    prefix ^= prefix << 1;
+    prefix ^= prefix << 2;
+    prefix ^= prefix << 4;
+    prefix ^= prefix << 8;
+    prefix ^= prefix << 16;
+    return (reverseBits(prefix & lowBits(rounds)) >> (32 - rounds)) + 1;
+}
+
+uint32_t Bracket::lineOf(uint32_t seed, int rounds) {
+    if (rounds == 0) {
+        return 0;
+    }
+    uint32_t prefix = reverseBits(seed - 1) >> (32 - rounds);
+    return (prefix ^ (prefix << 1)) & lowBits(rounds);
+}
+
+int Bracket::roundOf(uint32_t match) const {
+    return rounds - (31 - __builtin_clz(match));
+}
+
+void Bracket::decideBySeed() {
+    for (uint32_t match = slots - 1; match >= 1; match--) {
+        uint32_t first = nodes[2 * match];
+        uint32_t second = nodes[2 * match + 1];
+        if (nodes[match] == NO_SEED && first != NO_SEED && second != NO_SEED) {
+            nodes[match] = min(first, second);
+        }
+    }
+}
+
+vector<BracketChange> Bracket::reportResult(uint32_t match, uint32_t winner) {
+    if (match < 1 || match >= slots) {
+        throw invalid_argument("No match " + to_string(match) + " in a bracket of " +
+                               to_string(slots) + " lines");
+    }
+    uint32_t first = nodes[2 * match];
+    uint32_t second = nodes[2 * match + 1];
+    if (isBye(second)) {
+        throw invalid_argument("Match " + to_string(match) + " is a bye");
+    }
+    if (winner != NO_SEED && (first == NO_SEED || second == NO_SEED)) {
+        throw invalid_argument("Match " + to_string(match) + " does not have both players yet");
+    }
+    if (winner != NO_SEED && winner != first && winner != second) {
+        throw invalid_argument("Seed " + to_string(winner) + " is not playing match " + to_string(match));
+    }
+
+    vector<BracketChange> changes;
+    uint32_t previous = nodes[match];
+    if (previous == winner) {
+        return changes;
+    }
+    nodes[match] = winner;
+    changes.push_back({match, winner});
+    // One side of the next match is now someone else (or nobody), so its
+    // result no longer stands, whoever it went to; the same holds for each
+    // match above a result that gets cleared
+    for (uint32_t node = match / 2; node >= 1 && nodes[node] != NO_SEED; node /= 2) {
+        nodes[node] = NO_SEED;
+        changes.push_back({node, NO_SEED});
+    }
+    version++;
+    return changes;
+}
+
+json Bracket::toJson(const vector<string>& names) const {
+    if (names.size() != entrants) {
+        throw invalid_argument("Expected " + to_string(entrants) + " names, got " + to_string(names.size()));
+    }
+    auto player = [&](uint32_t seed) {
+        if (seed == NO_SEED || isBye(seed)) {
+            return json();
+        }
+        return json{{"name", names[seed - 1]}, {"seed", seed}};
+    };
+
+    json players = json::array();
+    for (uint32_t seed = 1; seed <= entrants; seed++) {
+        players.push_back(player(seed));
+    }
+    json roundList = json::array();
+    for (int round = 1; round <= rounds; round++) {
+        json matches = json::array();
+        for (uint32_t match = slots >> round; match < (slots >> (round - 1)); match++) {
+            matches.push_back({{"match", match},
+                               {"player1", player(nodes[2 * match])},
+                               {"player2", player(nodes[2 * match + 1])},
+                               {"winner", player(nodes[match])},
+                               {"round", round}});
+        }
+        roundList.push_back(move(matches));
+    }
+    json winner = player(nodes[1]);
+    return {{"players", move(players)},
+            {"rounds", move(roundList)},
+            {"winner", winner.is_null() ? json("No winner") : winner["name"]}};
+}
+
+vector<uint8_t> Bracket::toPacked() const {
+    vector<uint8_t> out = {'B', 'R', 'K', '1'};
+    out.reserve(PACKED_BRACKET_HEADER_BYTES + 4 * nodes.size());
+    auto put = [&](uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(uint8_t(value >> shift));
+        }
+    };
+    put(entrants);
+    put(slots);
+    for (uint32_t node : nodes) {
+        put(node);
+    }
+    return out;
+}
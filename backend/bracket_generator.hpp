@@ -0,0 +1,89 @@
+#ifndef BRACKET_GENERATOR_HPP
+#define BRACKET_GENERATOR_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "json.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+const uint32_t MIN_BRACKET_ENTRANTS = 2;
+const uint32_t MAX_BRACKET_ENTRANTS = 1u << 24;
+const size_t PACKED_BRACKET_HEADER_BYTES = 12;
+
+// A match whose outcome changed: seed is its new winner, NO_SEED when the
+// match became undecided
+struct BracketChange {
+    uint32_t match;
+    uint32_t seed;
+};
+
+// Single-elimination bracket for entrants seeded 1..n (1 is the best),
+// kept as a complete binary tree in one flat array:
+//
+//   node 1 is the final, the two matches feeding match m are 2m and 2m + 1,
+//   and nodes slots .. 2 * slots - 1 are the first-round lines
+//
+// where slots is n rounded up to a power of two. A line holds the seed
+// placed on it; a seed past n is a bye. A match holds the seed that comes
+// out of it, or NO_SEED while it is undecided. Building is O(n): every
+// line's seed comes from a closed form, and byes (which the top seeds get)
+// advance while the lines are filled.
+class Bracket {
+public:
+    static constexpr uint32_t NO_SEED = 0;
+
+    explicit Bracket(size_t entrantCount);
+
+    uint32_t getEntrants() const { return entrants; }
+    uint32_t getSlots() const { return slots; }
+    int getRounds() const { return rounds; }
+
+    // Standard seeding over 2^rounds lines: seeds s and 2^rounds + 1 - s
+    // meet in round 1, and seeds 1 and 2 can only meet in the final
+    static uint32_t seedAt(uint32_t line, int rounds);
+    static uint32_t lineOf(uint32_t seed, int rounds);
+
+    // Seed on a line (slots <= node < 2 * slots) or out of a match
+    uint32_t getSeed(uint32_t node) const { return nodes.at(node); }
+    bool isBye(uint32_t seed) const { return seed > entrants; }
+
+    // Round 1 is played by the lines, round getRounds() is the final
+    int roundOf(uint32_t match) const;
+
+    // Settles every undecided match in favour of the better seed, the rule
+    // the seeding assumes
+    void decideBySeed();
+
+    // Sets the winner of a match, or clears its result with NO_SEED, and
+    // returns the matches whose outcome changed, this one first. Every
+    // decided result further up the path is cleared, whichever side won it,
+    // since one of its players has changed; only the path to the final is
+    // visited, so this is O(log n). The version counts changes that were
+    // not no-ops.
+    vector<BracketChange> reportResult(uint32_t match, uint32_t winner);
+    uint64_t getVersion() const { return version; }
+
+    // Same layout as generateBracket in server/server.js: players, then one
+    // array of {player1, player2, winner, round} per round, then the
+    // winner's name. names[i] is seed i + 1. Each match also carries its
+    // node number as "match", the handle for reportResult.
+    json toJson(const vector<string>& names) const;
+
+    // The tree as is, packed little endian:
+    //   "BRK1" | u32 entrants | u32 slots | u32 node[2 * slots]
+    // for clients that lay out large brackets themselves
+    vector<uint8_t> toPacked() const;
+
+private:
+    uint32_t entrants;
+    uint32_t slots;
+    int rounds;
+    vector<uint32_t> nodes; // [0] unused
+    uint64_t version = 0;
+};
+
+#endif // BRACKET_GENERATOR_HPP
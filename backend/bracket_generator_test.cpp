@@ -0,0 +1,144 @@
+// Behaviour checks for Bracket; exits non-zero on the first failure.
+//   g++ -O2 -std=c++17 -o build/bracket_test.exe backend/bracket_generator_test.cpp backend/bracket_generator.cpp
+#include "bracket_generator.hpp"
+#include <iostream>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const string& what) {
+    if (!condition) {
+        cerr << "FAIL: " << what << "\n";
+        failures++;
+    }
+}
+
+bool sameChanges(const vector<BracketChange>& changes, const vector<BracketChange>& expected) {
+    if (changes.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (changes[i].match != expected[i].match || changes[i].seed != expected[i].seed) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Body>
+bool throwsInvalidArgument(Body body) {
+    try {
+        body();
+    } catch (const invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+void testSeeding() {
+    for (int rounds = 1; rounds <= 10; rounds++) {
+        uint32_t lines = 1u << rounds;
+        for (uint32_t line = 0; line < lines; line++) {
+            uint32_t seed = Bracket::seedAt(line, rounds);
+            check(Bracket::lineOf(seed, rounds) == line, "lineOf inverts seedAt");
+            // Round-1 opponents sit on lines 2m and 2m + 1 and add up to lines + 1
+            check(seed + Bracket::seedAt(line ^ 1, rounds) == lines + 1, "round-1 pairs sum to lines + 1");
+        }
+        if (rounds > 1) {
+            bool oneInTopHalf = Bracket::lineOf(1, rounds) < lines / 2;
+            bool twoInTopHalf = Bracket::lineOf(2, rounds) < lines / 2;
+            check(oneInTopHalf != twoInTopHalf, "seeds 1 and 2 only meet in the final");
+        }
+    }
+}
+
+void testByesAdvance() {
+    Bracket bracket(5); // 8 lines, seeds 6..8 are byes
+    check(bracket.getSlots() == 8 && bracket.getRounds() == 3, "5 entrants fill 8 lines");
+    int advanced = 0;
+    for (uint32_t match = 4; match < 8; match++) {
+        uint32_t second = bracket.getSeed(2 * match + 1);
+        if (bracket.isBye(second)) {
+            check(bracket.getSeed(match) == bracket.getSeed(2 * match), "a bye advances its opponent");
+            advanced++;
+        } else {
+            check(bracket.getSeed(match) == Bracket::NO_SEED, "a real first-round match starts undecided");
+        }
+    }
+    check(advanced == 3, "three byes advance");
+}
+
+// 4 entrants: match 2 is seed 1 v 4, match 3 is seed 2 v 3, match 1 the final
+void testChangedResultClearsLaterMatches() {
+    Bracket bracket(4);
+    check(bracket.getSeed(4) == 1 && bracket.getSeed(5) == 4, "match 2 is 1 v 4");
+    check(bracket.getSeed(6) == 2 && bracket.getSeed(7) == 3, "match 3 is 2 v 3");
+    bracket.reportResult(2, 1);
+    bracket.reportResult(3, 3);
+    bracket.reportResult(1, 1);
+
+    // The final was played against seed 3; with seed 2 through instead it
+    // has to be played again, even though seed 1 won it
+    auto changes = bracket.reportResult(3, 2);
+    check(sameChanges(changes, {{3, 2}, {1, Bracket::NO_SEED}}), "overturning a semi-final clears the final");
+    check(bracket.getSeed(1) == Bracket::NO_SEED, "the final is undecided again");
+
+    // Clearing a result behaves the same way
+    bracket.reportResult(1, 2);
+    changes = bracket.reportResult(2, Bracket::NO_SEED);
+    check(sameChanges(changes, {{2, Bracket::NO_SEED}, {1, Bracket::NO_SEED}}),
+          "clearing a semi-final clears the final");
+    check(bracket.getVersion() == 6, "every real change bumps the version");
+    check(bracket.reportResult(2, Bracket::NO_SEED).empty(), "a no-op reports nothing");
+    check(bracket.getVersion() == 6, "a no-op keeps the version");
+}
+
+void testCascadeStopsAtUndecided() {
+    Bracket bracket(8);
+    bracket.decideBySeed();
+    // Undo one quarter-final's semi-final, then change that quarter-final:
+    // only the cleared path is touched
+    bracket.reportResult(2, Bracket::NO_SEED); // the upper semi-final
+    check(bracket.getSeed(1) == Bracket::NO_SEED, "the final is cleared with its semi-final");
+    uint32_t quarter = 4;
+    uint32_t loser = bracket.getSeed(2 * quarter + 1);
+    auto changes = bracket.reportResult(quarter, loser);
+    check(sameChanges(changes, {{quarter, loser}}), "nothing above an undecided match changes");
+}
+
+void testValidation() {
+    Bracket bracket(5);
+    check(throwsInvalidArgument([&] { bracket.reportResult(0, 1); }), "match 0 does not exist");
+    check(throwsInvalidArgument([&] { bracket.reportResult(8, 1); }), "lines are not matches");
+    uint32_t byeMatch = 4;
+    while (!bracket.isBye(bracket.getSeed(2 * byeMatch + 1))) {
+        byeMatch++;
+    }
+    check(throwsInvalidArgument([&] { bracket.reportResult(byeMatch, 1); }), "byes cannot be reported");
+    check(throwsInvalidArgument([&] { bracket.reportResult(1, 1); }), "the final needs both players");
+    uint32_t playable = 4;
+    while (bracket.isBye(bracket.getSeed(2 * playable + 1))) {
+        playable++;
+    }
+    uint32_t outsider = bracket.getSeed(2 * playable) == 1 ? 2 : 1;
+    check(throwsInvalidArgument([&] { bracket.reportResult(playable, outsider); }),
+          "the winner must be playing the match");
+    check(throwsInvalidArgument([] { Bracket(1); }), "a bracket needs two entrants");
+}
+
+} // namespace
+
+int main() {
+    testSeeding();
+    testByesAdvance();
+    testChangedResultClearsLaterMatches();
+    testCascadeStopsAtUndecided();
+    testValidation();
+    if (failures > 0) {
+        cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    cout << "bracket tests passed\n";
+    return 0;
+}
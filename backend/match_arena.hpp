@@ -0,0 +1,81 @@
+#ifndef MATCH_ARENA_HPP
+#define MATCH_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+// Monotonic memory for the temporaries of one match (a player's visited
+// set and trail, a solver's frontier and parent table). Allocation bumps a
+// pointer, deallocation does nothing, and reset() drops everything at
+// once. The buffer is kept between matches and grows to the largest match
+// seen, so once warm a match makes no heap allocations at all.
+//
+// Containers drawing from it must not outlive the next reset().
+class MatchArena : public pmr::memory_resource {
+public:
+    explicit MatchArena(size_t initialBytes = size_t(64) << 10) : buffer(initialBytes) {}
+
+    MatchArena(const MatchArena&) = delete;
+    MatchArena& operator=(const MatchArena&) = delete;
+
+    ~MatchArena() override { releaseOverflow(); }
+
+    void reset() {
+        // What did not fit this time goes into one larger buffer next time
+        if (overflowBytes > 0) {
+            size_t wanted = used + overflowBytes;
+            releaseOverflow();
+            buffer = vector<unsigned char>(wanted + wanted / 2);
+        }
+        used = 0;
+    }
+
+    size_t capacity() const { return buffer.size(); }
+
+    // The calling thread's arena, for one match at a time: each match
+    // resets it on entry, so it must not be held across another match
+    static MatchArena& forThisThread() {
+        thread_local MatchArena arena;
+        return arena;
+    }
+
+private:
+    vector<unsigned char> buffer;
+    size_t used = 0;
+    vector<pair<void*, size_t>> overflow; // (block, alignment) from operator new, freed on reset
+    size_t overflowBytes = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer.data());
+        size_t start = ((base + used + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+        if (start + bytes <= buffer.size()) {
+            used = start + bytes;
+            return buffer.data() + start;
+        }
+        void* block = ::operator new(bytes, align_val_t(alignment));
+        overflow.emplace_back(block, alignment);
+        overflowBytes += bytes + alignment;
+        return block;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void releaseOverflow() {
+        for (const auto& block : overflow) {
+            ::operator delete(block.first, align_val_t(block.second));
+        }
+        overflow.clear();
+        overflowBytes = 0;
+    }
+};
+
+#endif // MATCH_ARENA_HPP
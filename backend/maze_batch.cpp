@@ -0,0 +1,109 @@
+#include "maze_batch.hpp"
+#include "match_arena.hpp"
+
+namespace {
+
+// A unit of work ends after this many jobs or cells walked by players,
+// whichever comes first: enough for a worker to reuse its environment,
+// little enough that big and small jobs still balance across workers
+const size_t JOBS_PER_CHUNK = 16;
+const uint64_t CELLS_PER_CHUNK = uint64_t(1) << 16;
+
+template <typename T>
+void putArray(vector<uint8_t>& out, const vector<T>& values) {
+    for (T value : values) {
+        putLittleEndian<T>(out, value);
+    }
+}
+
+}
+
+BatchResults runMazeBatch(const MazeBatch& batch, const BatchOptions& options) {
+    size_t jobs = batch.size();
+    // players may have been filled in directly rather than through add, so
+    // the total is checked again, in 64 bits, before anything is allocated
+    uint64_t totalPlayers = 0;
+    for (size_t j = 0; j < jobs; j++) {
+        totalPlayers += batch.players[j];
+    }
+    if (totalPlayers > MAX_BATCH_PLAYERS) {
+        throw invalid_argument("A batch is limited to " + to_string(MAX_BATCH_PLAYERS) + " players in total");
+    }
+    BatchResults results;
+    results.firstPlayer.resize(jobs + 1);
+    results.firstPlayer[0] = 0;
+    for (size_t j = 0; j < jobs; j++) {
+        results.firstPlayer[j + 1] = results.firstPlayer[j] + batch.players[j];
+    }
+    size_t rowCount = results.firstPlayer[jobs];
+    results.totalReward.resize(rowCount);
+    results.steps.resize(rowCount);
+    results.revisits.resize(rowCount);
+    results.searchNodes.resize(rowCount);
+    results.termination.resize(rowCount);
+
+    // Equal shapes next to each other, so a chunk regenerates one
+    // environment whose buffers already have the right size
+    vector<uint32_t> order(jobs);
+    for (size_t j = 0; j < jobs; j++) {
+        order[j] = uint32_t(j);
+    }
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return make_pair(batch.rows[a], batch.cols[a]) < make_pair(batch.rows[b], batch.cols[b]);
+    });
+
+    vector<size_t> chunkStart = {0};
+    uint64_t chunkCells = 0;
+    for (size_t k = 0; k < jobs; k++) {
+        uint32_t j = order[k];
+        chunkCells += uint64_t(batch.rows[j]) * batch.cols[j] * batch.players[j];
+        if (k + 1 - chunkStart.back() == JOBS_PER_CHUNK || chunkCells >= CELLS_PER_CHUNK) {
+            chunkStart.push_back(k + 1);
+            chunkCells = 0;
+        }
+    }
+    if (chunkStart.back() != jobs) {
+        chunkStart.push_back(jobs);
+    }
+
+    // Every (job, player) owns its result row, so workers write without locks
+    parallelFor(chunkStart.size() - 1, options.threads, [&](size_t chunk) {
+        unique_ptr<MazeEnvironment> env;
+        for (size_t k = chunkStart[chunk]; k < chunkStart[chunk + 1]; k++) {
+            uint32_t j = order[k];
+            if (batch.players[j] == 0) {
+                continue;
+            }
+            if (!env) {
+                env.reset(new MazeEnvironment(batch.rows[j], batch.cols[j], batch.seeds[j], options.params));
+            } else {
+                env->regenerate(batch.rows[j], batch.cols[j], batch.seeds[j]);
+            }
+            for (uint32_t row = results.firstPlayer[j]; row < results.firstPlayer[j + 1]; row++) {
+                MatchArena& arena = MatchArena::forThisThread();
+                arena.reset();
+                MazePlayer player("", options.mode, &arena);
+                results.termination[row] = uint8_t(player.playMaze(*env, options.limits));
+                results.totalReward[row] = player.getTotalReward();
+                results.steps[row] = uint32_t(player.getSteps());
+                results.revisits[row] = uint32_t(player.getRevisits());
+                results.searchNodes[row] = player.getSearchStats().nodes;
+            }
+        }
+    });
+    return results;
+}
+
+vector<uint8_t> BatchResults::toPacked() const {
+    vector<uint8_t> out = {'M', 'Z', 'R', '1'};
+    out.reserve(BATCH_RESULTS_HEADER_BYTES + 4 * firstPlayer.size() + 21 * rowCount());
+    putLittleEndian<uint32_t>(out, uint32_t(jobCount()));
+    putLittleEndian<uint32_t>(out, uint32_t(rowCount()));
+    putArray(out, firstPlayer);
+    putArray(out, totalReward);
+    putArray(out, steps);
+    putArray(out, revisits);
+    putArray(out, searchNodes);
+    out.insert(out.end(), termination.begin(), termination.end());
+    return out;
+}
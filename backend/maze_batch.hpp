@@ -0,0 +1,80 @@
+#ifndef MAZE_BATCH_HPP
+#define MAZE_BATCH_HPP
+
+#include "maze_environment.hpp"
+
+// Many independent matches in one call. Jobs and results are kept as
+// parallel arrays rather than one object per match, and workers take jobs
+// in batches of equal-sized mazes, regenerating a single environment in
+// place instead of building one per job.
+//
+// The mazes themselves are not pooled: each worker holds one
+// MazeEnvironment at a time, and a job's grid exists only while its
+// players run. Players search through MazeEnvironment (its grid, shared
+// search table and distance cache), so a struct-of-arrays pool of grids
+// would need a non-owning environment view first.
+
+// Player runs in one batch, summed over its jobs: bounds the result rows
+// (21 bytes each) a single request can make the service allocate
+const uint64_t MAX_BATCH_PLAYERS = uint64_t(1) << 22;
+
+// Job i generates maze (seeds[i], rows[i] x cols[i]) and runs players[i]
+// players on it
+struct MazeBatch {
+    vector<uint64_t> seeds;
+    vector<uint16_t> rows;
+    vector<uint16_t> cols;
+    vector<uint32_t> players;
+    uint64_t totalPlayers = 0;
+
+    void add(uint64_t seed, int jobRows, int jobCols, int jobPlayers) {
+        MazeEnvironment::checkDimensions(jobRows, jobCols);
+        if (jobPlayers < 0) {
+            throw invalid_argument("A job cannot have a negative player count");
+        }
+        if (totalPlayers + uint64_t(jobPlayers) > MAX_BATCH_PLAYERS) {
+            throw invalid_argument("A batch is limited to " + to_string(MAX_BATCH_PLAYERS) + " players in total");
+        }
+        totalPlayers += uint64_t(jobPlayers);
+        seeds.push_back(seed);
+        rows.push_back(uint16_t(jobRows));
+        cols.push_back(uint16_t(jobCols));
+        players.push_back(uint32_t(jobPlayers));
+    }
+
+    size_t size() const { return seeds.size(); }
+};
+
+// Settings shared by every job of a batch
+struct BatchOptions {
+    SearchMode mode = ALPHA_BETA;
+    int threads = 0; // 0 = one worker per hardware thread
+    MazeParams params;
+    PlayLimits limits;
+};
+
+// One row per (job, player), job by job: the players of job j are rows
+// firstPlayer[j] .. firstPlayer[j + 1] - 1
+struct BatchResults {
+    vector<uint32_t> firstPlayer;
+    vector<int32_t> totalReward;
+    vector<uint32_t> steps;
+    vector<uint32_t> revisits;
+    vector<uint64_t> searchNodes;
+    vector<uint8_t> termination; // TerminationReason
+
+    size_t jobCount() const { return firstPlayer.empty() ? 0 : firstPlayer.size() - 1; }
+    size_t rowCount() const { return totalReward.size(); }
+
+    // Packed little endian, one array after another:
+    //   "MZR1" | u32 jobs | u32 rows | u32 firstPlayer[jobs + 1] |
+    //   i32 totalReward[rows] | u32 steps[rows] | u32 revisits[rows] |
+    //   u64 searchNodes[rows] | u8 termination[rows]
+    vector<uint8_t> toPacked() const;
+};
+
+const size_t BATCH_RESULTS_HEADER_BYTES = 12;
+
+BatchResults runMazeBatch(const MazeBatch& batch, const BatchOptions& options = BatchOptions());
+
+#endif // MAZE_BATCH_HPP
@@ -0,0 +1,498 @@
+// Benchmarks for the maze engine.
+//
+// A small harness in the spirit of Google Benchmark: every benchmark is
+// registered with a list of argument tuples, run with a growing iteration
+// count until it has been timed for --benchmark_min_time seconds, and
+// reported either as a console table or as JSON in Google Benchmark's
+// schema, so the usual compare tooling can diff two runs.
+//
+//   maze_benchmark [--benchmark_filter=<regex>] [--benchmark_min_time=<s>]
+//                  [--benchmark_format=console|json] [--benchmark_out=<file>]
+
+#include "bracket_generator.hpp"
+#include "maze_batch.hpp"
+#include "maze_bitboard.hpp"
+#include "maze_qlearning.hpp"
+#include "maze_value_iteration.hpp"
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <regex>
+
+using Clock = chrono::steady_clock;
+
+class BenchmarkState {
+public:
+    BenchmarkState(vector<long long> args, long long iterations)
+        : args(move(args)), iterations(iterations) {}
+
+    long long range(size_t i) const { return args.at(i); }
+    long long getIterations() const { return iterations; }
+
+    // while (state.keepRunning()) { ...timed body... }
+    bool keepRunning() {
+        if (done == 0) {
+            start();
+        }
+        if (done++ < iterations) {
+            return true;
+        }
+        stop();
+        return false;
+    }
+
+    // Exclude per-iteration setup from the measurement
+    void pauseTiming() { stop(); }
+    void resumeTiming() { start(); }
+
+    // Totals over all iterations; reported per iteration
+    map<string, double> counters;
+
+    double realSeconds = 0;
+    double cpuSeconds = 0;
+
+private:
+    vector<long long> args;
+    long long iterations;
+    long long done = 0;
+    Clock::time_point realStart;
+    clock_t cpuStart = 0;
+
+    void start() {
+        realStart = Clock::now();
+        cpuStart = clock();
+    }
+
+    void stop() {
+        realSeconds += chrono::duration<double>(Clock::now() - realStart).count();
+        cpuSeconds += double(clock() - cpuStart) / CLOCKS_PER_SEC;
+    }
+};
+
+struct Benchmark {
+    string name;
+    function<void(BenchmarkState&)> body;
+    vector<vector<long long>> argSets;
+};
+
+vector<Benchmark>& registry() {
+    static vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+void registerBenchmark(const string& name, function<void(BenchmarkState&)> body,
+                       vector<vector<long long>> argSets) {
+    registry().push_back({name, move(body), move(argSets)});
+}
+
+// Keeps the optimizer from discarding a result
+template <typename T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// --- Benchmarks ---
+
+MazeParams paramsFor(long long generator) {
+    MazeParams params;
+    params.generator = static_cast<MazeGenerator>(generator);
+    return params;
+}
+
+// args: size, generator
+void BM_InitializeMaze(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(state.range(1)));
+    uint64_t seed = 0;
+    while (state.keepRunning()) {
+        env.initializeMaze(seed++);
+    }
+    state.counters["cells"] = double(size) * size * state.getIterations();
+}
+
+// args: size, depth. Cold cache: every iteration starts from an empty table
+void BM_EvaluatePosition(BenchmarkState& state) {
+    int size = int(state.range(0));
+    int depth = int(state.range(1));
+    MazeEnvironment env(size, size, 1, paramsFor(SPANNING_TREE));
+    SearchStats stats;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        env.clearSearchCache();
+        state.resumeTiming();
+        doNotOptimize(env.evaluatePosition(Position(0, 0), depth, &stats));
+    }
+    state.counters["nodes"] = double(stats.nodes);
+}
+
+// args: size, depth
+void BM_AlphaBeta(BenchmarkState& state) {
+    int size = int(state.range(0));
+    int depth = int(state.range(1));
+    MazeEnvironment env(size, size, 1, paramsFor(SPANNING_TREE));
+    SearchStats stats;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        env.clearSearchCache();
+        state.resumeTiming();
+        doNotOptimize(env.alphaBeta(Position(0, 0), depth, -SCORE_INF - 1, SCORE_INF + 1, &stats));
+    }
+    state.counters["nodes"] = double(stats.nodes);
+}
+
+// args: size, mode. A single playMaze step is one getBestMove decision
+void BM_GetBestMove(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(SPANNING_TREE));
+    PlayLimits limits;
+    limits.maxSteps = 1;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        env.clearSearchCache();
+        MazePlayer player("bench", static_cast<SearchMode>(state.range(1)));
+        state.resumeTiming();
+        player.playMaze(env, limits);
+    }
+}
+
+// args: size, mode
+void BM_PlayMaze(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(CORRIDOR));
+    long long steps = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        env.clearSearchCache();
+        MazePlayer player("bench", static_cast<SearchMode>(state.range(1)));
+        state.resumeTiming();
+        player.playMaze(env);
+        steps += player.getSteps();
+    }
+    state.counters["steps"] = double(steps);
+}
+
+// args: size, nodes per move; iterative deepening under a node budget
+void BM_PlayMazeBudget(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(CORRIDOR));
+    PlayLimits limits;
+    limits.moveNodes = uint64_t(state.range(1));
+    long long steps = 0;
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        env.clearSearchCache();
+        MazePlayer player("bench", ALPHA_BETA);
+        state.resumeTiming();
+        player.playMaze(env, limits);
+        steps += player.getSteps();
+    }
+    state.counters["steps"] = double(steps);
+}
+
+// args: players, threads
+void BM_RunMazeTournament(BenchmarkState& state) {
+    vector<string> names;
+    for (long long i = 0; i < state.range(0); i++) {
+        names.push_back("player" + to_string(i));
+    }
+    TournamentOptions options;
+    options.threads = int(state.range(1));
+    options.seeded = true;
+    options.seed = 1;
+    while (state.keepRunning()) {
+        doNotOptimize(runMazeTournament(names, options));
+    }
+}
+
+// args: jobs, threads; two players on each of many small mazes, the
+// workload runMazeTournament pays per-call setup for
+void BM_RunMazeBatch(BenchmarkState& state) {
+    MazeBatch batch;
+    for (long long i = 0; i < state.range(0); i++) {
+        batch.add(uint64_t(i), 16, 16, 2);
+    }
+    BatchOptions options;
+    options.threads = int(state.range(1));
+    while (state.keepRunning()) {
+        doNotOptimize(runMazeBatch(batch, options));
+    }
+    state.counters["matches"] = 2.0 * state.range(0) * state.getIterations();
+}
+
+// args: agents, size; random actions, fixed up front so only step() is timed
+void BM_VecEnvStep(BenchmarkState& state) {
+    int size = int(state.range(1));
+    MazeEnvironment env(size, size, 1, paramsFor(RANDOM_WALLS));
+    VecMazeEnv vec(env, size_t(state.range(0)));
+    CounterRng rng(1, 0);
+    vector<uint8_t> actions(vec.size() * 64);
+    for (size_t i = 0; i < actions.size(); i++) {
+        actions[i] = uint8_t(rng.at(i) & 3);
+    }
+    vector<int32_t> rewards(vec.size());
+    vector<uint8_t> dones(vec.size());
+    size_t round = 0;
+    while (state.keepRunning()) {
+        vec.step(actions.data() + (round++ % 64) * vec.size(), rewards.data(), dones.data());
+        doNotOptimize(dones[0]);
+    }
+    state.counters["steps"] = double(vec.size()) * state.getIterations();
+}
+
+// args: size; a full training run with the default options
+void BM_TrainQLearning(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(CORRIDOR));
+    long long steps = 0;
+    while (state.keepRunning()) {
+        QLearningPolicy policy(env);
+        policy.train();
+        steps += policy.getTrainedSteps();
+    }
+    state.counters["steps"] = double(steps);
+}
+
+// args: size; play only, against a policy trained up front
+void BM_PlayPolicy(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(CORRIDOR));
+    QLearningPolicy policy(env);
+    policy.train();
+    long long steps = 0;
+    while (state.keepRunning()) {
+        MazePlayer player("bench", policy);
+        player.playMaze(env);
+        steps += player.getSteps();
+    }
+    state.counters["steps"] = double(steps);
+}
+
+// args: size, threads; a full solve, counting cell updates over all sweeps
+void BM_ValueIteration(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(RANDOM_WALLS));
+    ValueIterationOptions options;
+    options.threads = int(state.range(1));
+    long long sweeps = 0;
+    while (state.keepRunning()) {
+        ValueIterationPolicy policy(env, options);
+        sweeps += policy.getSweeps();
+    }
+    state.counters["cells"] = double(sweeps) * size * size;
+}
+
+// args: size, generator
+void BM_DistanceField(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(state.range(1)));
+    MazeBitboard board(env);
+    while (state.keepRunning()) {
+        doNotOptimize(board.distanceField(env.getGoal()));
+    }
+    state.counters["cells"] = double(size) * size * state.getIterations();
+}
+
+// args: size, generator
+void BM_IsSolvable(BenchmarkState& state) {
+    int size = int(state.range(0));
+    MazeEnvironment env(size, size, 1, paramsFor(state.range(1)));
+    MazeBitboard board(env);
+    while (state.keepRunning()) {
+        doNotOptimize(board.isSolvable());
+    }
+    state.counters["cells"] = double(size) * size * state.getIterations();
+}
+
+// args: entrants
+void BM_BuildBracket(BenchmarkState& state) {
+    while (state.keepRunning()) {
+        Bracket bracket(size_t(state.range(0)));
+        bracket.decideBySeed();
+        doNotOptimize(bracket.getSeed(1));
+    }
+    state.counters["entrants"] = double(state.range(0)) * state.getIterations();
+}
+
+// args: entrants (a power of two, so there are no byes); the top seed
+// wins every match on its path to the final, then its first-round result
+// is overturned, which clears that whole path again
+void BM_ReportResult(BenchmarkState& state) {
+    Bracket bracket(size_t(state.range(0)));
+    bracket.decideBySeed();
+    uint32_t first = bracket.getSlots() / 2;
+    uint32_t opponent = bracket.getSeed(2 * first + 1);
+    long long reports = 0, changes = 0;
+    while (state.keepRunning()) {
+        for (uint32_t match = first; match >= 1; match /= 2) {
+            changes += bracket.reportResult(match, 1).size();
+            reports++;
+        }
+        changes += bracket.reportResult(first, opponent).size();
+        reports++;
+    }
+    state.counters["reports"] = double(reports);
+    state.counters["changes"] = double(changes);
+}
+
+void registerAll() {
+    registerBenchmark("BM_InitializeMaze", BM_InitializeMaze,
+                      {{10, 0}, {10, 1}, {10, 2}, {256, 0}, {256, 1}, {256, 2},
+                       {4096, 0}, {4096, 1}, {4096, 2}});
+    registerBenchmark("BM_EvaluatePosition", BM_EvaluatePosition,
+                      {{10, 3}, {10, 6}, {10, 9}, {256, 3}, {256, 6}, {256, 9}});
+    registerBenchmark("BM_AlphaBeta", BM_AlphaBeta,
+                      {{10, 3}, {10, 6}, {10, 9}, {256, 3}, {256, 6}, {256, 9}});
+    registerBenchmark("BM_GetBestMove", BM_GetBestMove,
+                      {{10, NEGAMAX}, {10, ALPHA_BETA}, {10, DISTANCE_FIELD},
+                       {256, NEGAMAX}, {256, ALPHA_BETA}, {256, DISTANCE_FIELD}});
+    registerBenchmark("BM_PlayMaze", BM_PlayMaze,
+                      {{10, NEGAMAX}, {10, ALPHA_BETA}, {64, ALPHA_BETA}, {256, ALPHA_BETA},
+                       {256, DISTANCE_FIELD}, {4096, DISTANCE_FIELD}});
+    registerBenchmark("BM_VecEnvStep", BM_VecEnvStep,
+                      {{64, 16}, {4096, 16}, {4096, 256}});
+    registerBenchmark("BM_TrainQLearning", BM_TrainQLearning, {{10}, {64}});
+    registerBenchmark("BM_PlayPolicy", BM_PlayPolicy, {{10}, {64}, {256}});
+    registerBenchmark("BM_ValueIteration", BM_ValueIteration, {{256, 1}, {1024, 1}, {1024, 0}});
+    registerBenchmark("BM_PlayMazeBudget", BM_PlayMazeBudget,
+                      {{64, 200}, {64, 5000}, {256, 5000}});
+    registerBenchmark("BM_DistanceField", BM_DistanceField,
+                      {{256, 1}, {256, 2}, {4096, 1}, {4096, 2}});
+    registerBenchmark("BM_IsSolvable", BM_IsSolvable,
+                      {{256, 1}, {256, 2}, {4096, 1}, {4096, 2}});
+    registerBenchmark("BM_RunMazeTournament", BM_RunMazeTournament,
+                      {{8, 1}, {64, 1}, {64, 0}, {1024, 1}, {1024, 0}});
+    registerBenchmark("BM_RunMazeBatch", BM_RunMazeBatch,
+                      {{64, 1}, {1024, 1}, {1024, 0}});
+    registerBenchmark("BM_BuildBracket", BM_BuildBracket,
+                      {{8}, {1000}, {1000000}});
+    registerBenchmark("BM_ReportResult", BM_ReportResult, {{8}, {1024}, {1 << 20}});
+}
+
+// --- Runner ---
+
+struct BenchmarkResult {
+    string name;
+    long long iterations;
+    double realNs;
+    double cpuNs;
+    map<string, double> counters;
+};
+
+// Grows the iteration count (at most 10x per round, like Google
+// Benchmark) until one run lasts at least minTime seconds
+BenchmarkResult runBenchmark(const string& name, const Benchmark& benchmark,
+                             const vector<long long>& args, double minTime) {
+    long long iterations = 1;
+    while (true) {
+        BenchmarkState state(args, iterations);
+        benchmark.body(state);
+        double elapsed = state.realSeconds;
+        if (elapsed >= minTime || iterations >= 1000000000) {
+            BenchmarkResult result{name, iterations, state.realSeconds * 1e9 / iterations,
+                                   state.cpuSeconds * 1e9 / iterations, {}};
+            for (const auto& counter : state.counters) {
+                result.counters[counter.first] = counter.second / iterations;
+            }
+            return result;
+        }
+        double multiplier = elapsed > 0 ? minTime * 1.4 / elapsed : 10;
+        iterations = max(iterations + 1, (long long)(iterations * min(multiplier, 10.0)));
+    }
+}
+
+json toJson(const vector<BenchmarkResult>& results) {
+    json output;
+    time_t now = time(nullptr);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+    output["context"] = {
+        {"date", date},
+        {"num_cpus", thread::hardware_concurrency()},
+        {"library_build_type", "release"},
+    };
+    output["benchmarks"] = json::array();
+    for (const auto& result : results) {
+        json entry = {
+            {"name", result.name},
+            {"run_name", result.name},
+            {"run_type", "iteration"},
+            {"iterations", result.iterations},
+            {"real_time", result.realNs},
+            {"cpu_time", result.cpuNs},
+            {"time_unit", "ns"},
+        };
+        for (const auto& counter : result.counters) {
+            entry[counter.first] = counter.second;
+        }
+        output["benchmarks"].push_back(entry);
+    }
+    return output;
+}
+
+void printConsole(ostream& out, const BenchmarkResult& result) {
+    out << left << setw(40) << result.name << right
+        << setw(15) << fixed << setprecision(0) << result.realNs << " ns"
+        << setw(15) << result.cpuNs << " ns"
+        << setw(12) << result.iterations;
+    for (const auto& counter : result.counters) {
+        out << "  " << counter.first << "=" << setprecision(1) << counter.second;
+    }
+    out << "\n";
+}
+
+int main(int argc, char** argv) {
+    string filter = ".*";
+    string format = "console";
+    string outPath;
+    double minTime = 0.5;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        auto value = [&](const string& flag) { return arg.substr(flag.size()); };
+        if (arg.rfind("--benchmark_filter=", 0) == 0) {
+            filter = value("--benchmark_filter=");
+        } else if (arg.rfind("--benchmark_min_time=", 0) == 0) {
+            minTime = stod(value("--benchmark_min_time="));
+        } else if (arg.rfind("--benchmark_format=", 0) == 0) {
+            format = value("--benchmark_format=");
+        } else if (arg.rfind("--benchmark_out=", 0) == 0) {
+            outPath = value("--benchmark_out=");
+        } else {
+            cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    registerAll();
+    regex pattern(filter);
+    vector<BenchmarkResult> results;
+    if (format == "console") {
+        cout << left << setw(40) << "Benchmark" << right << setw(18) << "Time"
+             << setw(18) << "CPU" << setw(12) << "Iterations" << "\n";
+    }
+    for (const auto& benchmark : registry()) {
+        for (const auto& args : benchmark.argSets) {
+            string name = benchmark.name;
+            for (long long arg : args) {
+                name += "/" + to_string(arg);
+            }
+            if (!regex_search(name, pattern)) {
+                continue;
+            }
+            results.push_back(runBenchmark(name, benchmark, args, minTime));
+            if (format == "console") {
+                printConsole(cout, results.back());
+            }
+        }
+    }
+
+    if (format == "json") {
+        cout << toJson(results).dump(2) << "\n";
+    }
+    if (!outPath.empty()) {
+        ofstream out(outPath);
+        out << toJson(results).dump(2) << "\n";
+    }
+    return 0;
+}
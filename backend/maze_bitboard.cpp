@@ -0,0 +1,171 @@
+#include "maze_bitboard.hpp"
+#include <cstring>
+
+namespace {
+
+// Occluded fills (Kogge-Stone): spread the seed bits of x through the set
+// bits of open in six shift steps, towards higher or lower bit positions
+uint64_t fillUp(uint64_t x, uint64_t open) {
+    x |= (x << 1) & open; open &= open << 1;
+    x |= (x << 2) & open; open &= open << 2;
+    x |= (x << 4) & open; open &= open << 4;
+    x |= (x << 8) & open; open &= open << 8;
+    x |= (x << 16) & open; open &= open << 16;
+    return x | ((x << 32) & open);
+}
+
+uint64_t fillDown(uint64_t x, uint64_t open) {
+    x |= (x >> 1) & open; open &= open >> 1;
+    x |= (x >> 2) & open; open &= open >> 2;
+    x |= (x >> 4) & open; open &= open >> 4;
+    x |= (x >> 8) & open; open &= open >> 8;
+    x |= (x >> 16) & open; open &= open >> 16;
+    return x | ((x >> 32) & open);
+}
+
+// Sign bits of eight cells (negative codes are walls and border) as one
+// byte, bit k for the k-th cell
+uint64_t blockedBits(const Cell* cells) {
+    uint64_t block;
+    memcpy(&block, cells, sizeof(block));
+    return ((block & 0x8080808080808080ull) * 0x0002040810204081ull) >> 56;
+}
+
+} // namespace
+
+MazeBitboard::MazeBitboard(const MazeEnvironment& env)
+    : rows(env.getRows()), cols(env.getCols()), words((env.getCols() + 63) / 64),
+      open(size_t(rows) * words, 0) {
+    for (int i = 0; i < rows; i++) {
+        const Cell* row = env.getRow(i);
+        uint64_t* rowOpen = &open[size_t(i) * words];
+        int j = 0;
+        for (; j + 8 <= cols; j += 8) {
+            rowOpen[j >> 6] |= (~blockedBits(row + j) & 0xFF) << (j & 63);
+        }
+        for (; j < cols; j++) {
+            rowOpen[j >> 6] |= uint64_t(row[j] >= 0) << (j & 63);
+        }
+    }
+}
+
+// Breadth-first, one layer per step, over 64-cell words: each frontier
+// word pushes its bits sideways within the word (and across into the next
+// word), up and down in one go. Only words holding frontier bits are
+// touched, so the long thin frontiers of a maze cost a few words per layer
+// rather than the whole board.
+vector<int32_t> MazeBitboard::distanceField(Position target) const {
+    vector<int32_t> distance(size_t(rows) * cols, UNREACHABLE);
+    if (!isOpen(target)) {
+        return distance;
+    }
+
+    vector<uint64_t> unseen(open), next(open.size(), 0);
+    vector<pair<uint32_t, uint64_t>> frontier; // (word, bits) of the current layer
+    vector<uint32_t> touched;                  // words with bits in next
+
+    size_t targetWord = wordOf(target);
+    uint64_t targetBit = uint64_t(1) << (target.y & 63);
+    unseen[targetWord] &= ~targetBit;
+    frontier.emplace_back(uint32_t(targetWord), targetBit);
+    distance[size_t(target.x) * cols + target.y] = 0;
+
+    for (int32_t layer = 1; !frontier.empty(); layer++) {
+        auto push = [&](size_t word, uint64_t bits) {
+            bits &= unseen[word];
+            if (bits == 0) {
+                return;
+            }
+            unseen[word] &= ~bits;
+            if (next[word] == 0) {
+                touched.push_back(uint32_t(word));
+            }
+            next[word] |= bits;
+            size_t base = (word / words) * size_t(cols) + (word % words) * 64;
+            for (; bits; bits &= bits - 1) {
+                distance[base + __builtin_ctzll(bits)] = layer;
+            }
+        };
+
+        touched.clear();
+        for (const auto& entry : frontier) {
+            size_t word = entry.first;
+            uint64_t bits = entry.second;
+            size_t column = word % words;
+            push(word, (bits << 1) | (bits >> 1));
+            if (column > 0 && (bits & 1)) push(word - 1, uint64_t(1) << 63);
+            if (column + 1 < size_t(words) && (bits >> 63)) push(word + 1, 1);
+            if (word >= size_t(words)) push(word - words, bits);
+            if (word + words < open.size()) push(word + words, bits);
+        }
+
+        frontier.clear();
+        for (uint32_t word : touched) {
+            frontier.emplace_back(word, next[word]);
+            next[word] = 0;
+        }
+    }
+    return distance;
+}
+
+// Spreads bits along the open runs of one row: a carry-passing fill to the
+// right, then one to the left, covers runs that cross word boundaries
+void MazeBitboard::fillRow(uint64_t* bits, const uint64_t* rowOpen) const {
+    uint64_t carry = 0;
+    for (int w = 0; w < words; w++) {
+        bits[w] = fillUp(bits[w] | (carry & rowOpen[w]), rowOpen[w]);
+        carry = bits[w] >> 63;
+    }
+    carry = 0;
+    for (int w = words - 1; w >= 0; w--) {
+        bits[w] = fillDown(bits[w] | (carry & rowOpen[w]), rowOpen[w]);
+        carry = (bits[w] & 1) << 63;
+    }
+}
+
+// Alternating downward and upward sweeps: each row takes in whatever the
+// row before it reaches and fills its own runs, until a round adds nothing
+vector<uint64_t> MazeBitboard::reachable(Position from) const {
+    vector<uint64_t> bits(open.size(), 0);
+    if (!isOpen(from)) {
+        return bits;
+    }
+    bits[wordOf(from)] = uint64_t(1) << (from.y & 63);
+    fillRow(&bits[size_t(from.x) * words], &open[size_t(from.x) * words]);
+
+    auto pull = [&](int row, int source) {
+        uint64_t* target = &bits[size_t(row) * words];
+        const uint64_t* above = &bits[size_t(source) * words];
+        const uint64_t* rowOpen = &open[size_t(row) * words];
+        uint64_t added = 0;
+        for (int w = 0; w < words; w++) {
+            uint64_t entering = above[w] & rowOpen[w] & ~target[w];
+            target[w] |= entering;
+            added |= entering;
+        }
+        if (added) {
+            fillRow(target, rowOpen);
+        }
+        return added != 0;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 1; i < rows; i++) {
+            changed |= pull(i, i - 1);
+        }
+        for (int i = rows - 2; i >= 0; i--) {
+            changed |= pull(i, i + 1);
+        }
+    }
+    return bits;
+}
+
+bool MazeBitboard::isSolvable(Position start, Position goal) const {
+    if (!isOpen(start) || !isOpen(goal)) {
+        return false;
+    }
+    vector<uint64_t> bits = reachable(start);
+    return (bits[wordOf(goal)] >> (goal.y & 63)) & 1;
+}
@@ -0,0 +1,44 @@
+#ifndef MAZE_BITBOARD_HPP
+#define MAZE_BITBOARD_HPP
+
+#include "maze_environment.hpp"
+
+// Bit-parallel flood fills over a maze stored as row bitmasks: bit j of
+// word w in a row is column 64 * w + j, set when the cell can be entered.
+// Moving a whole frontier one step is a few shifts and masks per 64 cells
+// instead of four isValidMove calls per cell.
+class MazeBitboard {
+public:
+    static constexpr int32_t UNREACHABLE = UNREACHABLE_DISTANCE;
+
+    explicit MazeBitboard(const MazeEnvironment& env);
+
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+
+    bool isOpen(Position pos) const {
+        return (open[wordOf(pos)] >> (pos.y & 63)) & 1;
+    }
+
+    // Moves from every cell to target (UNREACHABLE where there is no path),
+    // indexed x * cols + y
+    vector<int32_t> distanceField(Position target) const;
+
+    // Cells connected to from, in the same row-mask layout as the board
+    vector<uint64_t> reachable(Position from) const;
+
+    bool isSolvable(Position start, Position goal) const;
+    bool isSolvable() const { return isSolvable(Position(0, 0), Position(rows - 1, cols - 1)); }
+
+private:
+    int rows;
+    int cols;
+    int words; // per row
+    vector<uint64_t> open;
+
+    size_t wordOf(Position pos) const { return size_t(pos.x) * words + (pos.y >> 6); }
+
+    void fillRow(uint64_t* bits, const uint64_t* rowOpen) const;
+};
+
+#endif // MAZE_BITBOARD_HPP
@@ -1,178 +1,176 @@
-
-#include <iostream>
-#include <vector>
-#include <random>
-#include <limits>
-#include "json.hpp"
-
-using namespace std;
-using json = nlohmann::json;
-
-const int MAZE_SIZE = 10;
-const int MAX_REWARD = 100;
-
-enum Direction { UP, DOWN, LEFT, RIGHT };
-
-struct Position {
-    int x, y;
-    Position(int x, int y) : x(x), y(y) {}
-    bool operator==(const Position& other) const {
-        return x == other.x && y == other.y;
+#include "maze_environment.hpp"
+#include "maze_bitboard.hpp"
+#include "match_arena.hpp"
+#include <cstring>
+#include <mutex>
+
+vector<uint8_t> MazeEnvironment::toPacked() const {
+    size_t cellCount = size_t(rows) * cols;
+    bool hasRewards = false;
+    for (int i = 0; i < rows && !hasRewards; i++) {
+        const Cell* row = &cells[index(Position(i, 0))];
+        hasRewards = any_of(row, row + cols, [](Cell cell) { return cell > OPEN; });
     }
-};
 
-class MazeEnvironment {
-public:
-    MazeEnvironment() {
-        initializeMaze();
+    vector<uint8_t> out;
+    out.reserve(PACKED_HEADER_BYTES + (cellCount + 7) / 8 + (hasRewards ? (cellCount + 1) / 2 : 0));
+    out.insert(out.end(), {'M', 'Z', 'B', '1'});
+    out.push_back(PACKED_MAZE_VERSION);
+    out.push_back(hasRewards ? PACKED_HAS_REWARDS : 0);
+    out.push_back(uint8_t(params.generator));
+    out.push_back(0);
+    putLittleEndian<uint16_t>(out, uint16_t(rows));
+    putLittleEndian<uint16_t>(out, uint16_t(cols));
+    putLittleEndian<uint64_t>(out, seed);
+    putLittleEndian<double>(out, params.wallDensity);
+    putLittleEndian<double>(out, params.loopDensity);
+
+    size_t walls = out.size();
+    out.resize(walls + (cellCount + 7) / 8, 0);
+    size_t rewards = out.size();
+    if (hasRewards) {
+        out.resize(rewards + (cellCount + 1) / 2, 0);
     }
-
-    void initializeMaze() {
-        maze = vector<vector<int>>(MAZE_SIZE, vector<int>(MAZE_SIZE, 0));
-        // Place walls randomly
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_int_distribution<> dis(0, 1);
-
-        for (int i = 0; i < MAZE_SIZE; i++) {
-            for (int j = 0; j < MAZE_SIZE; j++) {
-                if (dis(gen) == 1) {
-                    maze[i][j] = -1; // Wall
-                }
+    // Wall bits are gathered branch-free, a byte at a time
+    size_t cell = 0;
+    uint8_t bits = 0;
+    for (int i = 0; i < rows; i++) {
+        const Cell* row = &cells[index(Position(i, 0))];
+        for (int j = 0; j < cols; j++, cell++) {
+            bits |= uint8_t((row[j] == WALL) << (cell % 8));
+            if (cell % 8 == 7) {
+                out[walls + cell / 8] = bits;
+                bits = 0;
             }
         }
-        // Ensure start and end points are clear
-        maze[0][0] = 0;
-        maze[MAZE_SIZE-1][MAZE_SIZE-1] = 0;
+    }
+    if (cell % 8 != 0) {
+        out[walls + cell / 8] = bits;
     }
 
-    int getReward(Position pos) {
-        if (pos.x < 0 || pos.x >= MAZE_SIZE || pos.y < 0 || pos.y >= MAZE_SIZE) {
-            return -10; // Out of bounds hamra total size 10hai to 
-        }
-        if (maze[pos.x][pos.y] == -1) {
-            return -5; // Wall hai
-        }
-        if (pos.x == MAZE_SIZE-1 && pos.y == MAZE_SIZE-1) {
-            return MAX_REWARD; // Goal destination hai
+    if (hasRewards) {
+        cell = 0;
+        for (int i = 0; i < rows; i++) {
+            const Cell* row = &cells[index(Position(i, 0))];
+            for (int j = 0; j < cols; j++, cell++) {
+                if (row[j] > MAX_PACKED_REWARD) {
+                    throw invalid_argument("Rewards above " + to_string(MAX_PACKED_REWARD) +
+                                           " do not fit the packed format");
+                }
+                if (row[j] > OPEN) {
+                    out[rewards + cell / 2] |= uint8_t(row[j] << (4 * (cell % 2)));
+                }
+            }
         }
-        return 1; // Normal step hai
     }
+    return out;
+}
 
-    bool isValidMove(Position pos, Direction dir) {
-        Position newPos = getNextPosition(pos, dir);
-        return (newPos.x >= 0 && newPos.x < MAZE_SIZE &&
-                newPos.y >= 0 && newPos.y < MAZE_SIZE &&
-                maze[newPos.x][newPos.y] != -1);
+MazeEnvironment MazeEnvironment::fromPacked(const uint8_t* data, size_t size) {
+    if (size < PACKED_HEADER_BYTES || memcmp(data, "MZB1", 4) != 0) {
+        throw invalid_argument("Not a packed maze");
     }
-
-    Position getNextPosition(Position pos, Direction dir) {
-        switch(dir) {
-            case UP: return Position(pos.x - 1, pos.y);
-            case DOWN: return Position(pos.x + 1, pos.y);
-            case LEFT: return Position(pos.x, pos.y - 1);
-            case RIGHT: return Position(pos.x, pos.y + 1);
-        }
-        return pos;
+    if (data[4] != PACKED_MAZE_VERSION) {
+        throw invalid_argument("Unsupported packed maze version " + to_string(data[4]));
     }
-
-    int evaluatePosition(Position pos, int depth) {
-        if (depth == 0) {
-            return getReward(pos);
-        }
-
-        int bestScore = numeric_limits<int>::min();
-        for (int dir = 0; dir < 4; dir++) {
-            Position newPos = getNextPosition(pos, static_cast<Direction>(dir));
-            if (isValidMove(pos, static_cast<Direction>(dir))) {
-                int score = -evaluatePosition(newPos, depth - 1);
-                bestScore = max(bestScore, score);
-            }
-        }
-        return bestScore;
+    bool hasRewards = data[5] & PACKED_HAS_REWARDS;
+    if (data[6] > SPANNING_TREE) {
+        throw invalid_argument("Unknown packed maze generator " + to_string(data[6]));
     }
-
-    json getMazeState() {
-        json state;
-        state["maze"] = maze;
-        state["start"] = {0, 0};
-        state["goal"] = {MAZE_SIZE-1, MAZE_SIZE-1};
-        return state;
+    MazeParams params;
+    params.generator = static_cast<MazeGenerator>(data[6]);
+    int rows = getLittleEndian<uint16_t>(data + 8);
+    int cols = getLittleEndian<uint16_t>(data + 10);
+    uint64_t seed = getLittleEndian<uint64_t>(data + 12);
+    params.wallDensity = getLittleEndian<double>(data + 20);
+    params.loopDensity = getLittleEndian<double>(data + 28);
+
+    MazeEnvironment env(rows, cols, seed, params, UnfilledGrid());
+    size_t cellCount = size_t(rows) * cols;
+    const uint8_t* walls = data + PACKED_HEADER_BYTES;
+    const uint8_t* rewards = walls + (cellCount + 7) / 8;
+    if (size < size_t(rewards - data) + (hasRewards ? (cellCount + 1) / 2 : 0)) {
+        throw invalid_argument("Truncated packed maze");
     }
-
-private:
-    vector<vector<int>> maze;
-};
-
-class MazePlayer {
-public:
-    MazePlayer(string name) : name(name), totalReward(0) {}
-
-    void playMaze(MazeEnvironment& env) {
-        Position pos(0, 0);
-        int depth = 3; // Search depth for Minimax
-
-        while (pos.x != MAZE_SIZE-1 || pos.y != MAZE_SIZE-1) {
-            Direction bestMove = getBestMove(env, pos, depth);
-            Position newPos = env.getNextPosition(pos, bestMove);
-            
-            if (env.isValidMove(pos, bestMove)) {
-                totalReward += env.getReward(newPos);
-                pos = newPos;
+    size_t cell = 0;
+    for (int i = 0; i < rows; i++) {
+        Cell* row = &env.cells[env.index(Position(i, 0))];
+        for (int j = 0; j < cols; j++, cell++) {
+            if ((walls[cell / 8] >> (cell % 8)) & 1) {
+                row[j] = WALL;
+            } else if (hasRewards) {
+                row[j] = Cell((rewards[cell / 2] >> (4 * (cell % 2))) & 0xF);
             }
         }
     }
+    return env;
+}
 
-    int getTotalReward() const { return totalReward; }
-    string getName() const { return name; }
+json runMazeTournament(const vector<string>& playerNames, const TournamentOptions& options) {
+    uint64_t seed = options.seeded ? options.seed : MazeEnvironment::randomSeed();
+    const MazeEnvironment env(options.rows, options.cols, seed, options.params);
+    return runMazeTournament(playerNames, env, options);
+}
 
-private:
-    string name;
-    int totalReward;
+const vector<int32_t>& MazeEnvironment::getGoalDistances() const {
+    GoalDistanceCache& cache = *goalDistanceCache;
+    call_once(cache.computed, [&]() {
+        cache.distances = MazeBitboard(*this).distanceField(getGoal());
+    });
+    return cache.distances;
+}
 
-    Direction getBestMove(MazeEnvironment& env, Position pos, int depth) {
-        int bestScore = numeric_limits<int>::min();
-        Direction bestMove = UP;
+json playerResultJson(const PlayerResult& result) {
+    return {{"total_reward", result.totalReward},
+            {"search_nodes", result.searchNodes},
+            {"steps", result.steps},
+            {"revisits", result.revisits},
+            {"termination", terminationName(result.termination)}};
+}
 
-        for (int dir = 0; dir < 4; dir++) {
-            Position newPos = env.getNextPosition(pos, static_cast<Direction>(dir));
-            if (env.isValidMove(pos, static_cast<Direction>(dir))) {
-                int score = env.evaluatePosition(newPos, depth);
-                if (score > bestScore) {
-                    bestScore = score;
-                    bestMove = static_cast<Direction>(dir);
-                }
-            }
-        }
-        return bestMove;
-    }
-};
+json runMazeTournament(const vector<string>& playerNames, const MazeEnvironment& env,
+                       const TournamentOptions& options) {
+    // Collect the streamed records by player index so the output does not
+    // depend on scheduling
+    vector<PlayerResult> finished(playerNames.size());
+    streamMazeTournament(playerNames, env, options, [&](const PlayerResult& result) {
+        finished[result.index] = result;
+    });
 
-json runMazeTournament(const vector<string>& playerNames) {
     json results;
-    MazeEnvironment env;
-    vector<MazePlayer> players;
-
-    // Create players
-    for (const auto& name : playerNames) {
-        players.emplace_back(name);
+    for (const auto& result : finished) {
+        results[result.name] = playerResultJson(result);
     }
 
-    // Run maze for each player
-    for (auto& player : players) {
-        player.playMaze(env);
-        results[player.getName()]["total_reward"] = player.getTotalReward();
-    }
-
-    // Sort players by total reward
-    sort(players.begin(), players.end(), [](const MazePlayer& a, const MazePlayer& b) {
-        return a.getTotalReward() > b.getTotalReward();
+    // Sort players by total reward; ties keep their entry order
+    stable_sort(finished.begin(), finished.end(), [](const PlayerResult& a, const PlayerResult& b) {
+        return a.totalReward > b.totalReward;
     });
 
     // Assign rankings
-    for (int i = 0; i < players.size(); i++) {
-        results[players[i].getName()]["rank"] = i + 1;
+    for (size_t i = 0; i < finished.size(); i++) {
+        results[finished[i].name]["rank"] = i + 1;
     }
 
     return results;
 }
+
+void streamMazeTournament(const vector<string>& playerNames, const MazeEnvironment& env,
+                          const TournamentOptions& options,
+                          const function<void(const PlayerResult&)>& onResult) {
+    // Players only read the maze (the shared search cache is thread-safe),
+    // so they can all run at once. Each one lives only as long as its run,
+    // with its scratch in the worker's arena.
+    mutex resultMutex;
+    parallelFor(playerNames.size(), options.threads, [&](size_t i) {
+        MatchArena& arena = MatchArena::forThisThread();
+        arena.reset();
+        MazePlayer player(playerNames[i], options.mode, &arena);
+        player.playMaze(env, options.limits);
+        PlayerResult result{i, player.getName(), player.getTotalReward(),
+                            player.getSearchStats().nodes, player.getSteps(),
+                            player.getRevisits(), player.getTermination()};
+        lock_guard<mutex> lock(resultMutex);
+        onResult(result);
+    });
+}
@@ -0,0 +1,1099 @@
+#ifndef MAZE_ENVIRONMENT_HPP
+#define MAZE_ENVIRONMENT_HPP
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include "json.hpp"
+
+using namespace std;
+using json = nlohmann::json;
+
+const int MAZE_SIZE = 10; // default rows and columns
+const int MIN_MAZE_DIM = 2;
+const int MAX_MAZE_DIM = 4096; // cell indices must fit the 25-bit TT key field
+const int MAX_REWARD = 100;
+// Larger than any score a search can produce; also used for dead ends
+const int SCORE_INF = 1000000;
+const int MAX_SEARCH_DEPTH = 127; // the TT key keeps 7 bits of depth
+
+enum Direction { UP, DOWN, LEFT, RIGHT };
+
+// UP/DOWN and LEFT/RIGHT differ only in the lowest bit
+inline Direction opposite(Direction dir) {
+    return static_cast<Direction>(dir ^ 1);
+}
+
+// Row and column step of each Direction, followed by the four diagonals:
+// the first FOUR_CONNECTED entries are the moves a player makes, all
+// EIGHT_CONNECTED the full neighbourhood of a cell
+struct MoveDelta {
+    int dx, dy;
+};
+constexpr int FOUR_CONNECTED = 4;
+constexpr int EIGHT_CONNECTED = 8;
+constexpr MoveDelta MOVE_DELTAS[EIGHT_CONNECTED] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+
+// Offset of a cell in a row-major grid with a one-cell border ring,
+// (x + 1) * (cols + 2) + (y + 1): a neighbour is one addition away
+using CellIndex = uint32_t;
+
+// MOVE_DELTAS as CellIndex offsets for a row stride of cols + 2
+constexpr array<int, EIGHT_CONNECTED> moveOffsets(int stride) {
+    array<int, EIGHT_CONNECTED> offsets{};
+    for (int i = 0; i < EIGHT_CONNECTED; i++) {
+        offsets[i] = MOVE_DELTAS[i].dx * stride + MOVE_DELTAS[i].dy;
+    }
+    return offsets;
+}
+
+// The same table built at compile time, for grids of a fixed width
+template <int Stride>
+constexpr array<int, EIGHT_CONNECTED> FIXED_MOVE_OFFSETS = moveOffsets(Stride);
+
+// Storage type of a grid cell. int8_t holds every wall/reward code; widen it
+// here if a maze ever needs larger cell values.
+using Cell = int8_t;
+const Cell OPEN = 0;
+const Cell WALL = -1;
+const Cell BORDER = -2; // padding ring around the grid, never walkable
+// Positive cells are reward pickups (the Node server uses 1-5)
+const int MAX_CELL_REWARD = numeric_limits<Cell>::max();
+
+// DISTANCE_FIELD skips the tree search and steps down the exact
+// distance-to-goal field (MazeEnvironment::getGoalDistances)
+enum SearchMode { NEGAMAX, ALPHA_BETA, DISTANCE_FIELD };
+
+inline SearchMode parseSearchMode(const string& name) {
+    if (name == "negamax") return NEGAMAX;
+    if (name == "alpha_beta") return ALPHA_BETA;
+    if (name == "distance_field") return DISTANCE_FIELD;
+    throw invalid_argument("Unknown search mode: " + name);
+}
+
+// Distance field entry for a cell with no path to the target
+const int32_t UNREACHABLE_DISTANCE = -1;
+
+// Node counters filled in by the search, e.g. to compare how much of the
+// tree alpha-beta prunes against plain negamax
+struct SearchStats {
+    uint64_t nodes = 0;
+    uint64_t ttHits = 0;
+    uint64_t cutoffs = 0;
+};
+
+// Work allowed for one move's search. Once spent, the search unwinds at
+// once and stores nothing in the transposition table, so an interrupted
+// iteration cannot leave half-searched scores behind for other players.
+// The clock is read every TIME_CHECK_NODES nodes only.
+struct SearchBudget {
+    static constexpr uint64_t TIME_CHECK_NODES = 256;
+
+    uint64_t nodeLimit = 0; // stop once SearchStats::nodes reaches this; 0 = no limit
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max();
+    bool stopped = false;
+
+    bool spent(uint64_t nodes) {
+        if (!stopped && nodeLimit > 0 && nodes >= nodeLimit) {
+            stopped = true;
+        }
+        if (!stopped && nodes % TIME_CHECK_NODES == 0 &&
+            deadline != chrono::steady_clock::time_point::max() && chrono::steady_clock::now() >= deadline) {
+            stopped = true;
+        }
+        return stopped;
+    }
+};
+
+struct Position {
+    int x, y;
+    Position(int x, int y) : x(x), y(y) {}
+    bool operator==(const Position& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+// Direct-mapped cache of search results. Each entry packs the 32-bit
+// (position, depth) key, the bound type and a 24-bit score into one word
+// so a probe is one load. Entries are relaxed atomics: threads searching
+// the same maze share the table, and since every word carries its own key
+// a racing store can replace an entry but never corrupt one.
+class TranspositionTable {
+public:
+    // EXACT scores come from full windows, LOWER/UPPER from beta cutoffs
+    // and fail-low alpha-beta nodes
+    enum Bound : uint8_t { EXACT, LOWER, UPPER };
+
+    explicit TranspositionTable(size_t capacity = 1 << 12) {
+        size_t size = sizeFor(capacity);
+        entries.reset(new atomic<uint64_t>[size]);
+        mask = size - 1;
+        shift = 64;
+        for (size_t bits = size; bits > 1; bits >>= 1) {
+            shift--;
+        }
+        clear();
+    }
+
+    // Entries actually allocated for a requested capacity (at least two,
+    // so slot() never shifts by the full word)
+    static size_t sizeFor(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        return size;
+    }
+
+    size_t size() const { return mask + 1; }
+
+    // The cell takes the high 25 bits (a 4096x4096 grid with its border
+    // ring stays below 2^25), depth the low 7. Depth 0 is never stored, so
+    // a zero entry always means "empty".
+    static uint32_t makeKey(CellIndex cell, int depth) {
+        return (cell << 7) | uint32_t(depth);
+    }
+
+    bool probe(uint32_t key, int& score, Bound& bound) const {
+        uint64_t entry = entries[slot(key)].load(memory_order_relaxed);
+        if (uint32_t(entry >> 32) != key) {
+            return false;
+        }
+        bound = Bound((entry >> 24) & 0xFF);
+        score = int32_t(uint32_t(entry) << 8) >> 8; // sign-extend 24 bits
+        return true;
+    }
+
+    void store(uint32_t key, int score, Bound bound = EXACT) {
+        entries[slot(key)].store((uint64_t(key) << 32) | (uint64_t(bound) << 24) |
+                                 (uint32_t(score) & 0xFFFFFF),
+                                 memory_order_relaxed);
+    }
+
+    void clear() {
+        for (size_t i = 0; i <= mask; i++) {
+            entries[i].store(0, memory_order_relaxed);
+        }
+    }
+
+private:
+    unique_ptr<atomic<uint64_t>[]> entries;
+    size_t mask;
+    int shift; // 64 - log2(size)
+
+    // Fibonacci hashing: the top bits of the product depend on every key
+    // bit, while the low bits would only see the key's low bits (the depth)
+    size_t slot(uint32_t key) const {
+        return size_t((uint64_t(key) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+};
+
+// Runs body(i) for every i in [0, count) on a pool of worker threads that
+// pull indices from a shared counter, so uneven work balances itself.
+// With one worker (or one item) everything runs on the calling thread.
+template <typename Body>
+void parallelFor(size_t count, int threadCount, Body body) {
+    size_t workers = threadCount > 0 ? threadCount : max(1u, thread::hardware_concurrency());
+    workers = min(workers, count);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    atomic<size_t> next(0);
+    vector<thread> pool;
+    try {
+        for (size_t w = 0; w < workers; w++) {
+            pool.emplace_back([&]() {
+                for (size_t i; (i = next.fetch_add(1, memory_order_relaxed)) < count;) {
+                    body(i);
+                }
+            });
+        }
+    } catch (...) {
+        // Out of threads: stop the workers already started (they still
+        // reference next and body) before the failure unwinds this frame
+        next.store(count, memory_order_relaxed);
+        for (auto& worker : pool) {
+            worker.join();
+        }
+        throw;
+    }
+    for (auto& worker : pool) {
+        worker.join();
+    }
+}
+
+// Counter-based random numbers: value n of a stream is a pure function of
+// (seed, stream, n), so every cell can be drawn on its own, in any order
+// and on any thread, and still come out the same for the same seed.
+class CounterRng {
+public:
+    CounterRng(uint64_t seed, uint64_t stream) : key(mix(seed ^ mix(stream + 0x632BE59BD9B4E019ull))) {}
+
+    uint64_t at(uint64_t counter) const {
+        return mix(key + counter * 0x9E3779B97F4A7C15ull);
+    }
+
+    // Uniform double in [0, 1)
+    double uniform(uint64_t counter) const {
+        return double(at(counter) >> 11) * 0x1.0p-53;
+    }
+
+private:
+    uint64_t key;
+
+    // SplitMix64 finalizer
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+};
+
+// RANDOM_WALLS: independent walls, may leave the goal unreachable.
+// CORRIDOR: random walls plus a cleared monotone path from start to goal.
+// SPANNING_TREE: carved perfect maze, optionally with extra loops.
+// All of them run in O(rows * cols) with no regenerate-and-retry.
+enum MazeGenerator { RANDOM_WALLS, CORRIDOR, SPANNING_TREE };
+
+inline const char* generatorName(MazeGenerator generator) {
+    switch (generator) {
+        case RANDOM_WALLS: return "random_walls";
+        case CORRIDOR: return "corridor";
+        case SPANNING_TREE: return "spanning_tree";
+    }
+    return "unknown";
+}
+
+inline MazeGenerator parseGenerator(const string& name) {
+    for (MazeGenerator generator : {RANDOM_WALLS, CORRIDOR, SPANNING_TREE}) {
+        if (name == generatorName(generator)) {
+            return generator;
+        }
+    }
+    throw invalid_argument("Unknown maze generator: " + name);
+}
+
+// Everything besides (seed, rows, cols) that shapes a generated maze
+struct MazeParams {
+    MazeGenerator generator = CORRIDOR;
+    double wallDensity = 0.5; // RANDOM_WALLS and CORRIDOR
+    double loopDensity = 0.0; // SPANNING_TREE: share of leftover walls opened
+};
+
+// One RNG stream per generation step, so adding a step never shifts the
+// numbers an existing one draws
+enum RngStream : uint64_t { WALL_STREAM = 1, CORRIDOR_STREAM, CARVE_STREAM, LOOP_STREAM };
+
+// Packed binary maze (see MazeEnvironment::toPacked), little endian:
+//   "MZB1" | u8 version | u8 flags | u8 generator | u8 reserved |
+//   u16 rows | u16 cols | u64 seed | f64 wall density | f64 loop density |
+//   wall plane: rows * cols bits, row-major, cell i in bit i % 8 of byte i / 8
+//   reward plane (only with PACKED_HAS_REWARDS): one nibble per cell,
+//   low nibble first
+// A 4096x4096 maze is 2 MB this way against ~50 MB of getMazeState JSON.
+const uint8_t PACKED_MAZE_VERSION = 1;
+const uint8_t PACKED_HAS_REWARDS = 1;
+const size_t PACKED_HEADER_BYTES = 36;
+const int MAX_PACKED_REWARD = 15;
+
+// Byte order helpers for the packed formats
+template <typename T>
+void putLittleEndian(vector<uint8_t>& out, T value) {
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out.push_back(uint8_t(bits >> (8 * i)));
+    }
+}
+
+template <typename T>
+T getLittleEndian(const uint8_t* data) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        bits |= uint64_t(data[i]) << (8 * i);
+    }
+    T value;
+    memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+class MazeEnvironment {
+public:
+    MazeEnvironment(int rows = MAZE_SIZE, int cols = MAZE_SIZE) : rows(rows), cols(cols) {
+        checkDimensions(rows, cols);
+        initializeMaze();
+    }
+
+    // Rebuilds exactly the maze getSeed() returned for the same arguments
+    MazeEnvironment(int rows, int cols, uint64_t seed, const MazeParams& params = MazeParams())
+        : rows(rows), cols(cols), params(params) {
+        checkDimensions(rows, cols);
+        initializeMaze(seed);
+    }
+
+    // Loads an existing grid (e.g. one generated by the Node server):
+    // -1 is a wall, 0 an open cell, 1..MAX_CELL_REWARD a reward pickup
+    explicit MazeEnvironment(const vector<vector<int>>& grid)
+        : rows(int(grid.size())), cols(grid.empty() ? 0 : int(grid[0].size())), seed(0) {
+        checkDimensions(rows, cols);
+        allocateGrid();
+        for (int i = 0; i < rows; i++) {
+            if (int(grid[i].size()) != cols) {
+                throw invalid_argument("Maze rows must all have the same length");
+            }
+            for (int j = 0; j < cols; j++) {
+                int value = grid[i][j];
+                if (value < WALL || value > MAX_CELL_REWARD) {
+                    throw invalid_argument("Maze cell values must be between -1 and " +
+                                           to_string(MAX_CELL_REWARD));
+                }
+                cells[index(Position(i, j))] = Cell(value);
+            }
+        }
+        allocateSearchCache();
+    }
+
+    // Generates a fresh maze from a random seed
+    void initializeMaze() {
+        initializeMaze(randomSeed());
+    }
+
+    static void checkDimensions(int rows, int cols) {
+        if (rows < MIN_MAZE_DIM || rows > MAX_MAZE_DIM || cols < MIN_MAZE_DIM || cols > MAX_MAZE_DIM) {
+            throw invalid_argument("Maze dimensions must be between " + to_string(MIN_MAZE_DIM) +
+                                   " and " + to_string(MAX_MAZE_DIM));
+        }
+    }
+
+    // 53 bits, so the seed survives a trip through a JSON number (a double
+    // in JavaScript) and the maze can be rebuilt from the reported seed
+    static uint64_t randomSeed() {
+        random_device rd;
+        return ((uint64_t(rd()) << 32) | rd()) & ((uint64_t(1) << 53) - 1);
+    }
+
+    void initializeMaze(uint64_t newSeed) {
+        seed = newSeed;
+        allocateGrid();
+        switch (params.generator) {
+            case RANDOM_WALLS:
+                placeRandomWalls();
+                break;
+            case CORRIDOR:
+                placeRandomWalls();
+                carveCorridor();
+                break;
+            case SPANNING_TREE:
+                carveSpanningTree();
+                break;
+        }
+        // Ensure start and end points are clear
+        cells[index(Position(0, 0))] = OPEN;
+        cells[index(getGoal())] = OPEN;
+        // Cached scores belong to the previous layout
+        allocateSearchCache();
+    }
+
+    // Reuses this environment's buffers for another generated maze, e.g.
+    // one worker running many batch jobs; the same maze as constructing
+    // MazeEnvironment(newRows, newCols, newSeed, getParams()) afresh
+    void regenerate(int newRows, int newCols, uint64_t newSeed) {
+        checkDimensions(newRows, newCols);
+        rows = newRows;
+        cols = newCols;
+        initializeMaze(newSeed);
+    }
+
+    // Drops every cached search result, e.g. to time a cold search. The
+    // goal distance field is a property of the layout and stays.
+    void clearSearchCache() {
+        transpositionTable.clear();
+    }
+
+    uint64_t getSeed() const { return seed; }
+    const MazeParams& getParams() const { return params; }
+    // Raw cell code: WALL, OPEN or a reward; BORDER just outside the grid
+    Cell getCell(Position pos) const { return cells[index(pos)]; }
+    // Cells (x, 0) .. (x, cols - 1), contiguous, for bulk readers
+    const Cell* getRow(int x) const { return &cells[index(Position(x, 0))]; }
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    Position getGoal() const { return Position(rows - 1, cols - 1); }
+
+    // Exact moves from every cell to the goal (UNREACHABLE_DISTANCE where
+    // there is no path), indexed x * cols + y. Computed by one reverse
+    // flood on first use and then shared by every player of this maze.
+    const vector<int32_t>& getGoalDistances() const;
+    int32_t getGoalDistance(Position pos) const {
+        return getGoalDistances()[size_t(pos.x) * cols + pos.y];
+    }
+
+    // Memory this maze holds or will hold once searched: the padded grid,
+    // the transposition table and the goal distance field
+    size_t footprintBytes() const {
+        return cells.size() * sizeof(Cell) + transpositionTable.size() * sizeof(uint64_t) +
+               size_t(rows) * cols * sizeof(int32_t);
+    }
+
+    CellIndex cellIndex(Position pos) const { return CellIndex(index(pos)); }
+    Position positionOf(CellIndex cell) const {
+        return Position(int(cell / stride) - 1, int(cell % stride) - 1);
+    }
+
+    // move is a Direction, or 4..7 for the diagonals of MOVE_DELTAS
+    CellIndex neighbour(CellIndex cell, int move) const { return cell + stepOffsets[move]; }
+
+    // pos must lie inside the grid or on the BORDER ring around it
+    int getReward(CellIndex cell) const { return rewardAt<0, 0>(cell); }
+    int getReward(Position pos) const { return getReward(cellIndex(pos)); }
+
+    // getReward of every cell, border ring included, indexed by CellIndex:
+    // a flat table for kernels that read rewards in bulk
+    vector<int32_t> rewardTable() const {
+        vector<int32_t> table(cells.size());
+        for (size_t cell = 0; cell < table.size(); cell++) {
+            table[cell] = getReward(CellIndex(cell));
+        }
+        return table;
+    }
+
+    // pos must lie inside the grid; BORDER and WALL are both negative
+    bool isValidMove(CellIndex cell, Direction dir) const { return cells[neighbour(cell, dir)] >= 0; }
+    bool isValidMove(Position pos, Direction dir) const { return isValidMove(cellIndex(pos), dir); }
+
+    Position getNextPosition(Position pos, Direction dir) const {
+        return Position(pos.x + MOVE_DELTAS[dir].dx, pos.y + MOVE_DELTAS[dir].dy);
+    }
+
+    // The default 10x10 maze takes a copy of the search where the shape is
+    // a compile-time constant; every other size uses the runtime shape.
+    // With a budget (which needs stats to count nodes), the result is
+    // meaningless once budget->stopped is set.
+    int evaluatePosition(Position pos, int depth, SearchStats* stats = nullptr,
+                         SearchBudget* budget = nullptr) const {
+        if (rows == MAZE_SIZE && cols == MAZE_SIZE) {
+            return negamax<MAZE_SIZE, MAZE_SIZE>(cellIndex(pos), depth, stats, budget);
+        }
+        return negamax<0, 0>(cellIndex(pos), depth, stats, budget);
+    }
+
+    // Same value as evaluatePosition whenever it lies inside (alpha, beta);
+    // otherwise a bound on the far side of the window (fail-soft)
+    int alphaBeta(Position pos, int depth, int alpha, int beta, SearchStats* stats = nullptr,
+                  SearchBudget* budget = nullptr) const {
+        if (rows == MAZE_SIZE && cols == MAZE_SIZE) {
+            return alphaBetaSearch<MAZE_SIZE, MAZE_SIZE>(cellIndex(pos), depth, alpha, beta, stats, budget);
+        }
+        return alphaBetaSearch<0, 0>(cellIndex(pos), depth, alpha, beta, stats, budget);
+    }
+
+    // Compact alternative to getMazeState; throws if a reward does not fit
+    // in a nibble
+    vector<uint8_t> toPacked() const;
+    static MazeEnvironment fromPacked(const uint8_t* data, size_t size);
+
+    json getMazeState() const {
+        json state;
+        vector<vector<int>> maze(rows, vector<int>(cols));
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                maze[i][j] = cells[index(Position(i, j))];
+            }
+        }
+        state["maze"] = maze;
+        state["start"] = {0, 0};
+        state["goal"] = {rows-1, cols-1};
+        state["seed"] = seed;
+        state["generator"] = generatorName(params.generator);
+        state["wall_density"] = params.wallDensity;
+        state["loop_density"] = params.loopDensity;
+        return state;
+    }
+
+private:
+    int rows, cols;
+    uint64_t seed;
+    MazeParams params;
+    vector<Cell> cells;
+    int stride;
+    array<int, EIGHT_CONNECTED> stepOffsets; // moveOffsets(stride)
+    // Search caches, not maze state: const searches still fill them
+    mutable TranspositionTable transpositionTable;
+    struct GoalDistanceCache {
+        once_flag computed;
+        vector<int32_t> distances;
+    };
+    mutable unique_ptr<GoalDistanceCache> goalDistanceCache;
+
+    // Rows are independent, so big grids fill them on every core
+    int generationThreads() const {
+        return size_t(rows) * cols >= (1 << 20) ? 0 : 1;
+    }
+
+    // Each cell draws its own counter, so the walls come out the same
+    // whichever thread fills which row
+    void placeRandomWalls() {
+        CounterRng rng(seed, WALL_STREAM);
+        parallelFor(rows, generationThreads(), [&](size_t i) {
+            Cell* row = &cells[index(Position(int(i), 0))];
+            uint64_t counter = uint64_t(i) * cols;
+            for (int j = 0; j < cols; j++) {
+                row[j] = rng.uniform(counter + j) < params.wallDensity ? WALL : OPEN;
+            }
+        });
+    }
+
+    // Clears a random monotone staircase from start to goal: each step goes
+    // down or right with odds proportional to the distance left that way
+    void carveCorridor() {
+        CounterRng rng(seed, CORRIDOR_STREAM);
+        int x = 0, y = 0;
+        cells[index(Position(x, y))] = OPEN;
+        for (uint64_t step = 0; x < rows - 1 || y < cols - 1; step++) {
+            int down = rows - 1 - x;
+            int right = cols - 1 - y;
+            if (rng.uniform(step) * (down + right) < down) {
+                x++;
+            } else {
+                y++;
+            }
+            cells[index(Position(x, y))] = OPEN;
+        }
+    }
+
+    // Binary-tree spanning tree over the rooms at even coordinates: every
+    // room but the start opens the wall to its upper or left room, which
+    // ties all rooms to the start. A room only writes its own row and the
+    // one above, so room rows carve in parallel.
+    void carveSpanningTree() {
+        CounterRng carve(seed, CARVE_STREAM);
+        CounterRng loops(seed, LOOP_STREAM);
+        for (int i = 0; i < rows; i++) {
+            fill_n(cells.begin() + index(Position(i, 0)), cols, WALL);
+        }
+        parallelFor((rows + 1) / 2, generationThreads(), [&](size_t roomRow) {
+            int i = int(roomRow) * 2;
+            for (int j = 0; j < cols; j += 2) {
+                cells[index(Position(i, j))] = OPEN;
+                if (i == 0 && j == 0) {
+                    continue;
+                }
+                uint64_t counter = uint64_t(i) * cols + j;
+                bool openUp = i > 0 && (j == 0 || (carve.at(counter) & 1));
+                Position treeWall = openUp ? Position(i - 1, j) : Position(i, j - 1);
+                cells[index(treeWall)] = OPEN;
+                // The other wall becomes a loop with probability loopDensity
+                bool hasOther = openUp ? j > 0 : i > 0;
+                if (hasOther && loops.uniform(counter) < params.loopDensity) {
+                    Position otherWall = openUp ? Position(i, j - 1) : Position(i - 1, j);
+                    cells[index(otherWall)] = OPEN;
+                }
+            }
+        });
+        // With an even row or column count the goal is not a room; link it
+        // to the nearest room up and to the left
+        Position pos = getGoal();
+        cells[index(pos)] = OPEN;
+        if (pos.x % 2 == 1) {
+            pos.x--;
+            cells[index(pos)] = OPEN;
+        }
+        if (pos.y % 2 == 1) {
+            pos.y--;
+            cells[index(pos)] = OPEN;
+        }
+    }
+
+    // Called for every new layout. One entry per cell and search depth (up
+    // to 16) stays small enough to reset cheaply on tiny mazes; a 4096x4096
+    // maze stops at 32 MB. The distance field is recomputed on demand.
+    void allocateSearchCache() {
+        size_t capacity = max(min(size_t(rows) * cols * 16, size_t(1) << 22), size_t(1) << 12);
+        if (transpositionTable.size() == TranspositionTable::sizeFor(capacity)) {
+            transpositionTable.clear();
+        } else {
+            transpositionTable = TranspositionTable(capacity);
+        }
+        goalDistanceCache.reset(new GoalDistanceCache());
+    }
+
+    // Grid of OPEN cells with no generation step, filled in by fromPacked
+    struct UnfilledGrid {};
+    MazeEnvironment(int rows, int cols, uint64_t seed, const MazeParams& params, UnfilledGrid)
+        : rows(rows), cols(cols), seed(seed), params(params) {
+        checkDimensions(rows, cols);
+        allocateGrid();
+        for (int i = 0; i < rows; i++) {
+            fill_n(cells.begin() + index(Position(i, 0)), cols, OPEN);
+        }
+        allocateSearchCache();
+    }
+
+    // Row-major with a one-cell BORDER ring, so a neighbour of any in-grid
+    // cell can be read without a bounds check
+    void allocateGrid() {
+        stride = cols + 2;
+        stepOffsets = moveOffsets(stride);
+        cells.assign(size_t(rows + 2) * stride, BORDER);
+    }
+
+    int index(Position pos) const {
+        return (pos.x + 1) * stride + (pos.y + 1);
+    }
+
+    // Shape helpers for the search: FixedRows/FixedCols are the grid size
+    // when known at compile time, or 0 to read it from the environment
+    template <int FixedCols>
+    int stepOffset(int move) const {
+        return FixedCols ? FIXED_MOVE_OFFSETS<FixedCols + 2>[move] : stepOffsets[move];
+    }
+
+    template <int FixedRows, int FixedCols>
+    bool isGoal(CellIndex cell) const {
+        const int goalRow = FixedRows ? FixedRows : rows;
+        const int goalCol = FixedCols ? FixedCols : cols;
+        return cell == CellIndex(goalRow * (FixedCols ? FixedCols + 2 : stride) + goalCol);
+    }
+
+    template <int FixedRows, int FixedCols>
+    int rewardAt(CellIndex index) const {
+        Cell cell = cells[index];
+        if (cell == BORDER) {
+            return -10; // Out of bounds hamra total size 10hai to 
+        }
+        if (cell == WALL) {
+            return -5; // Wall hai
+        }
+        if (isGoal<FixedRows, FixedCols>(index)) {
+            return MAX_REWARD; // Goal destination hai
+        }
+        if (cell > OPEN) {
+            return cell; // Reward pickup
+        }
+        return 1; // Normal step hai
+    }
+
+    template <int FixedRows, int FixedCols>
+    int negamax(CellIndex cell, int depth, SearchStats* stats, SearchBudget* budget) const {
+        if (stats) stats->nodes++;
+        if (budget && budget->spent(stats->nodes)) {
+            return 0;
+        }
+        if (depth == 0) {
+            return rewardAt<FixedRows, FixedCols>(cell);
+        }
+
+        // The score only depends on (cell, depth), so it can be shared by
+        // every turn and every player searching this maze
+        uint32_t key = TranspositionTable::makeKey(cell, depth);
+        int cached;
+        TranspositionTable::Bound bound;
+        if (transpositionTable.probe(key, cached, bound) && bound == TranspositionTable::EXACT) {
+            if (stats) stats->ttHits++;
+            return cached;
+        }
+
+        int bestScore = -SCORE_INF;
+        for (int dir = 0; dir < FOUR_CONNECTED; dir++) {
+            CellIndex next = cell + stepOffset<FixedCols>(dir);
+            if (cells[next] >= 0) {
+                int score = -negamax<FixedRows, FixedCols>(next, depth - 1, stats, budget);
+                if (budget && budget->stopped) {
+                    return 0;
+                }
+                bestScore = max(bestScore, score);
+            }
+        }
+        transpositionTable.store(key, bestScore);
+        return bestScore;
+    }
+
+    template <int FixedRows, int FixedCols>
+    int alphaBetaSearch(CellIndex cell, int depth, int alpha, int beta, SearchStats* stats,
+                        SearchBudget* budget) const {
+        if (stats) stats->nodes++;
+        if (budget && budget->spent(stats->nodes)) {
+            return 0;
+        }
+        if (depth == 0) {
+            return rewardAt<FixedRows, FixedCols>(cell);
+        }
+
+        uint32_t key = TranspositionTable::makeKey(cell, depth);
+        int cached;
+        TranspositionTable::Bound bound;
+        if (transpositionTable.probe(key, cached, bound) &&
+            (bound == TranspositionTable::EXACT ||
+             (bound == TranspositionTable::LOWER && cached >= beta) ||
+             (bound == TranspositionTable::UPPER && cached <= alpha))) {
+            if (stats) stats->ttHits++;
+            return cached;
+        }
+
+        CellIndex moves[FOUR_CONNECTED];
+        int moveCount = orderMoves<FixedCols>(cell, moves);
+        if (moveCount == 0) {
+            transpositionTable.store(key, -SCORE_INF);
+            return -SCORE_INF;
+        }
+
+        int originalAlpha = alpha;
+        int bestScore = -SCORE_INF;
+        for (int i = 0; i < moveCount; i++) {
+            int score = -alphaBetaSearch<FixedRows, FixedCols>(moves[i], depth - 1, -beta, -alpha,
+                                                               stats, budget);
+            if (budget && budget->stopped) {
+                return 0;
+            }
+            bestScore = max(bestScore, score);
+            alpha = max(alpha, score);
+            if (alpha >= beta) {
+                if (stats) stats->cutoffs++;
+                break;
+            }
+        }
+
+        if (bestScore <= originalAlpha) {
+            bound = TranspositionTable::UPPER;
+        } else if (bestScore >= beta) {
+            bound = TranspositionTable::LOWER;
+        } else {
+            bound = TranspositionTable::EXACT;
+        }
+        transpositionTable.store(key, bestScore, bound);
+        return bestScore;
+    }
+
+    // Cells of the valid moves, closest to the goal first, so the goal
+    // reward is found early and raises alpha before the rest of the
+    // siblings are searched. The goal is the bottom-right corner, so DOWN
+    // and RIGHT always bring a move one step closer and UP and LEFT one
+    // step further: the order is fixed and needs no distances.
+    template <int FixedCols>
+    int orderMoves(CellIndex cell, CellIndex moves[FOUR_CONNECTED]) const {
+        static constexpr Direction GOAL_FIRST[FOUR_CONNECTED] = {DOWN, RIGHT, UP, LEFT};
+        int count = 0;
+        for (Direction dir : GOAL_FIRST) {
+            CellIndex next = cell + stepOffset<FixedCols>(dir);
+            moves[count] = next;
+            count += cells[next] >= 0;
+        }
+        return count;
+    }
+};
+
+// Why playMaze stopped
+enum TerminationReason { GOAL_REACHED, STEP_LIMIT, DEADLINE, CANCELLED, GOAL_UNREACHABLE };
+
+inline const char* terminationName(TerminationReason reason) {
+    switch (reason) {
+        case GOAL_REACHED: return "goal_reached";
+        case STEP_LIMIT: return "step_limit";
+        case DEADLINE: return "deadline";
+        case CANCELLED: return "cancelled";
+        case GOAL_UNREACHABLE: return "goal_unreachable";
+    }
+    return "unknown";
+}
+
+// Bounds for one playMaze run, checked before every move
+struct PlayLimits {
+    long long maxSteps = 0;                 // 0 = 4 * rows * cols
+    chrono::milliseconds timeLimit{0};      // 0 = no deadline
+    const atomic<bool>* cancel = nullptr;   // stop as soon as it reads true
+
+    // Search effort per move. With no budget every move searches to
+    // searchDepth. With a node or time budget, each move deepens from 1
+    // until the budget is spent (or MAX_SEARCH_DEPTH) and plays the move
+    // of the deepest iteration that finished; depth 1 always finishes, so
+    // there is always a move. Either budget alone is the knob that trades
+    // quality for throughput.
+    int searchDepth = 3;
+    uint64_t moveNodes = 0;                 // 0 = no node budget
+    chrono::microseconds moveTime{0};       // 0 = no time budget
+
+    bool hasMoveBudget() const { return moveNodes > 0 || moveTime.count() > 0; }
+};
+
+// A strategy worked out ahead of play for one maze, e.g. a learned
+// Q-table: how good each move out of a cell is, higher is better. A
+// MazePlayer given one reads it instead of searching, O(1) per move.
+class MovePolicy {
+public:
+    virtual ~MovePolicy() = default;
+    virtual float moveValue(CellIndex cell, Direction move) const = 0;
+};
+
+class MazePlayer {
+public:
+    // memory backs the per-run visited set and trail, e.g. a MatchArena
+    // that is reset between matches
+    MazePlayer(string name, SearchMode mode = ALPHA_BETA,
+               pmr::memory_resource* memory = pmr::get_default_resource())
+        : name(name), totalReward(0), mode(mode), visited(memory), trail(memory) {}
+
+    // Plays by policy, which must outlive the player and have been built
+    // for the maze it is asked to play
+    MazePlayer(string name, const MovePolicy& policy,
+               pmr::memory_resource* memory = pmr::get_default_resource())
+        : MazePlayer(name, ALPHA_BETA, memory) {
+        this->policy = &policy;
+    }
+
+    TerminationReason playMaze(const MazeEnvironment& env, const PlayLimits& limits = PlayLimits()) {
+        if (limits.searchDepth < 1 || limits.searchDepth > MAX_SEARCH_DEPTH) {
+            throw invalid_argument("searchDepth must be between 1 and " + to_string(MAX_SEARCH_DEPTH));
+        }
+        Position pos(0, 0);
+        Position goal = env.getGoal();
+        long long maxSteps = limits.maxSteps > 0
+            ? limits.maxSteps : 4LL * env.getRows() * env.getCols();
+        auto deadline = chrono::steady_clock::now() + limits.timeLimit;
+
+        // Every cell is entered forward at most once and left backwards at
+        // most once, so a run takes at most 2 * rows * cols moves
+        int cols = env.getCols();
+        visited.assign((size_t(env.getRows()) * cols + 63) / 64, 0);
+        trail.clear();
+        markVisited(pos, cols);
+
+        steps = 0;
+        revisits = 0;
+        termination = GOAL_REACHED;
+        while (!(pos == goal)) {
+            if (steps >= maxSteps) {
+                termination = STEP_LIMIT;
+                break;
+            }
+            if (limits.cancel && limits.cancel->load(memory_order_relaxed)) {
+                termination = CANCELLED;
+                break;
+            }
+            if (limits.timeLimit.count() > 0 && chrono::steady_clock::now() >= deadline) {
+                termination = DEADLINE;
+                break;
+            }
+
+            Direction move;
+            if (getBestMove(env, pos, limits, move)) {
+                trail.push_back(move);
+            } else if (!trail.empty()) {
+                // Dead end: step back the way we came
+                move = opposite(trail.back());
+                trail.pop_back();
+                revisits++;
+            } else {
+                termination = GOAL_UNREACHABLE; // explored everything reachable
+                break;
+            }
+            pos = env.getNextPosition(pos, move);
+            markVisited(pos, cols);
+            totalReward += env.getReward(pos);
+            steps++;
+        }
+        return termination;
+    }
+
+    int getTotalReward() const { return totalReward; }
+    string getName() const { return name; }
+    const SearchStats& getSearchStats() const { return stats; }
+    long long getSteps() const { return steps; }
+    long long getRevisits() const { return revisits; }
+    TerminationReason getTermination() const { return termination; }
+
+private:
+    string name;
+    int totalReward;
+    SearchMode mode;
+    const MovePolicy* policy = nullptr;
+    SearchStats stats;
+    long long steps = 0;
+    long long revisits = 0;
+    TerminationReason termination = GOAL_REACHED;
+    pmr::vector<uint64_t> visited; // one bit per cell, x * cols + y
+    pmr::vector<Direction> trail;  // forward moves from the start, for backtracking
+
+    bool isVisited(Position pos, int cols) const {
+        size_t cell = size_t(pos.x) * cols + pos.y;
+        return (visited[cell / 64] >> (cell % 64)) & 1;
+    }
+
+    void markVisited(Position pos, int cols) {
+        size_t cell = size_t(pos.x) * cols + pos.y;
+        visited[cell / 64] |= uint64_t(1) << (cell % 64);
+    }
+
+    // Best move to a cell this run has not visited yet; returns false when
+    // there is none, so playMaze backtracks instead of oscillating
+    bool getBestMove(const MazeEnvironment& env, Position pos, const PlayLimits& limits, Direction& bestMove) {
+        if (policy) {
+            return getPolicyMove(env, pos, bestMove);
+        }
+        if (mode == DISTANCE_FIELD) {
+            return getNearestMove(env, pos, bestMove);
+        }
+        if (!limits.hasMoveBudget()) {
+            return searchRoot(env, pos, limits.searchDepth, nullptr, nullptr, bestMove);
+        }
+
+        // Iterative deepening. Each iteration tries the previous one's move
+        // first, so alpha-beta starts from a strong bound, and its subtrees
+        // find the (cell, depth) scores the last iteration stored, so it
+        // mostly pays for the new deepest layer.
+        if (!searchRoot(env, pos, 1, nullptr, nullptr, bestMove)) {
+            return false;
+        }
+        SearchBudget budget;
+        if (limits.moveNodes > 0) {
+            budget.nodeLimit = stats.nodes + limits.moveNodes;
+        }
+        if (limits.moveTime.count() > 0) {
+            budget.deadline = chrono::steady_clock::now() + limits.moveTime;
+        }
+        for (int depth = 2; depth <= MAX_SEARCH_DEPTH; depth++) {
+            Direction move;
+            Direction previous = bestMove;
+            searchRoot(env, pos, depth, &budget, &previous, move);
+            if (budget.stopped) {
+                break; // keep the deepest finished iteration's move
+            }
+            bestMove = move;
+        }
+        return true;
+    }
+
+    // One search of every unvisited root move to depth, first tried first
+    // when given. Otherwise root moves keep their fixed order so both modes
+    // break ties the same way; alpha-beta only needs to know whether a move
+    // beats the best one so far.
+    bool searchRoot(const MazeEnvironment& env, Position pos, int depth, SearchBudget* budget,
+                    const Direction* first, Direction& bestMove) {
+        int bestScore = -SCORE_INF - 1;
+        int cols = env.getCols();
+        Direction order[FOUR_CONNECTED] = {UP, DOWN, LEFT, RIGHT};
+        if (first) {
+            rotate(order, order + *first, order + *first + 1);
+        }
+        for (Direction dir : order) {
+            Position newPos = env.getNextPosition(pos, dir);
+            if (env.isValidMove(pos, dir) && !isVisited(newPos, cols)) {
+                int score = mode == ALPHA_BETA
+                    ? env.alphaBeta(newPos, depth, bestScore, SCORE_INF, &stats, budget)
+                    : env.evaluatePosition(newPos, depth, &stats, budget);
+                if (budget && budget->stopped) {
+                    return false;
+                }
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestMove = dir;
+                }
+            }
+        }
+        return bestScore > -SCORE_INF - 1;
+    }
+
+    // Unvisited neighbour with the fewest moves left to the goal: one
+    // table read per move instead of a search tree. Following it from a
+    // cell that can reach the goal never needs to backtrack.
+    bool getNearestMove(const MazeEnvironment& env, Position pos, Direction& bestMove) {
+        uint32_t bestDistance = 0;
+        bool found = false;
+        int cols = env.getCols();
+        for (int dir = 0; dir < 4; dir++) {
+            Position newPos = env.getNextPosition(pos, static_cast<Direction>(dir));
+            if (env.isValidMove(pos, static_cast<Direction>(dir)) && !isVisited(newPos, cols)) {
+                stats.nodes++;
+                // As unsigned, unreachable cells rank behind every other move
+                uint32_t distance = uint32_t(env.getGoalDistance(newPos));
+                if (!found || distance < bestDistance) {
+                    bestDistance = distance;
+                    bestMove = static_cast<Direction>(dir);
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    // Unvisited neighbour the policy values most; ties keep the fixed
+    // move order
+    bool getPolicyMove(const MazeEnvironment& env, Position pos, Direction& bestMove) {
+        float bestValue = 0;
+        bool found = false;
+        int cols = env.getCols();
+        CellIndex cell = env.cellIndex(pos);
+        for (int dir = 0; dir < 4; dir++) {
+            Direction move = static_cast<Direction>(dir);
+            if (env.isValidMove(cell, move) && !isVisited(env.getNextPosition(pos, move), cols)) {
+                stats.nodes++;
+                float value = policy->moveValue(cell, move);
+                if (!found || value > bestValue) {
+                    bestValue = value;
+                    bestMove = move;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+};
+
+struct TournamentOptions {
+    int rows = MAZE_SIZE;
+    int cols = MAZE_SIZE;
+    SearchMode mode = ALPHA_BETA;
+    int threads = 0; // 0 = one worker per hardware thread
+    bool seeded = false; // false: draw a fresh random seed
+    uint64_t seed = 0;
+    MazeParams params;
+    PlayLimits limits;
+};
+
+// One player's finished run, as handed to a streaming tournament
+struct PlayerResult {
+    size_t index; // position in playerNames
+    string name;
+    int totalReward;
+    uint64_t searchNodes;
+    long long steps;
+    long long revisits;
+    TerminationReason termination;
+};
+
+// The per-player record of the tournament results (everything but "rank")
+json playerResultJson(const PlayerResult& result);
+
+json runMazeTournament(const vector<string>& playerNames,
+                       const TournamentOptions& options = TournamentOptions());
+
+// Plays an existing maze (e.g. a cached one whose search table is already
+// warm); the maze fields of options are ignored
+json runMazeTournament(const vector<string>& playerNames, const MazeEnvironment& env,
+                       const TournamentOptions& options = TournamentOptions());
+
+// Streaming form: onResult gets each player's record as soon as its run
+// finishes, in completion order and never from two threads at once.
+// Nothing is kept per player, so memory does not grow with the field;
+// ranking is left to the consumer.
+void streamMazeTournament(const vector<string>& playerNames, const MazeEnvironment& env,
+                          const TournamentOptions& options,
+                          const function<void(const PlayerResult&)>& onResult);
+
+#endif // MAZE_ENVIRONMENT_HPP
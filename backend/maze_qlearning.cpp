@@ -0,0 +1,62 @@
+#include "maze_qlearning.hpp"
+
+QLearningPolicy::QLearningPolicy(const MazeEnvironment& env)
+    : env(env), table(size_t(env.getRows() + 2) * (env.getCols() + 2)) {}
+
+Direction QLearningPolicy::greedyMove(CellIndex cell) const {
+    const float* value = table[cell].value;
+    int best = 0;
+    for (int move = 1; move < FOUR_CONNECTED; move++) {
+        best = value[move] > value[best] ? move : best;
+    }
+    return static_cast<Direction>(best);
+}
+
+float QLearningPolicy::bestValue(CellIndex cell) const {
+    const float* value = table[cell].value;
+    return max(max(value[0], value[1]), max(value[2], value[3]));
+}
+
+void QLearningPolicy::train(const QLearningOptions& options) {
+    if (options.agents == 0) {
+        throw invalid_argument("Q-learning needs at least one agent");
+    }
+    uint64_t totalSteps = options.steps > 0
+        ? options.steps : 1000ull * env.getRows() * env.getCols();
+    size_t agents = options.agents;
+    uint64_t batches = max<uint64_t>(1, totalSteps / agents);
+
+    VecMazeEnv vec(env, agents, options.maxEpisodeSteps);
+    vector<CellIndex> from(agents);
+    vector<uint8_t> actions(agents);
+    vector<int32_t> rewards(agents);
+    vector<uint8_t> dones(agents);
+    CounterRng rng(options.seed, trainedSteps);
+
+    for (uint64_t batch = 0; batch < batches; batch++) {
+        float progress = batches > 1 ? float(batch) / float(batches - 1) : 1.0f;
+        float epsilon = options.epsilonStart + (options.epsilonEnd - options.epsilonStart) * progress;
+
+        copy(vec.getCells(), vec.getCells() + agents, from.begin());
+        for (size_t i = 0; i < agents; i++) {
+            uint64_t draw = rng.at(batch * agents + i);
+            bool explore = double(draw >> 11) * 0x1.0p-53 < epsilon;
+            // The low bits are free once the top 53 have decided exploring
+            actions[i] = explore ? uint8_t(draw & 3) : uint8_t(greedyMove(from[i]));
+        }
+        vec.step(actions.data(), rewards.data(), dones.data());
+
+        // VecMazeEnv has already reset finished agents, so the cell each
+        // move led to is recovered from the reward: only enterable cells
+        // pay more than zero. Reaching the goal ends the return; running
+        // out of steps does not, so those still bootstrap.
+        for (size_t i = 0; i < agents; i++) {
+            CellIndex target = env.neighbour(from[i], actions[i]);
+            CellIndex next = rewards[i] > 0 ? target : from[i];
+            float future = (dones[i] & DONE_GOAL) ? 0.0f : options.discount * bestValue(next);
+            float& value = table[from[i]].value[actions[i]];
+            value += options.learningRate * (float(rewards[i]) + future - value);
+        }
+    }
+    trainedSteps += batches * agents;
+}
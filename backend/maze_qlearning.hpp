@@ -0,0 +1,56 @@
+#ifndef MAZE_QLEARNING_HPP
+#define MAZE_QLEARNING_HPP
+
+#include "maze_vec_env.hpp"
+
+struct QLearningOptions {
+    size_t agents = 256;             // episodes run side by side, one VecMazeEnv
+    uint64_t steps = 0;              // agent steps in total; 0 = 1000 * rows * cols
+    uint32_t maxEpisodeSteps = 0;    // 0 = VecMazeEnv's default
+    float learningRate = 0.5f;
+    float discount = 0.95f;
+    float epsilonStart = 1.0f;       // exploration rate, decayed linearly
+    float epsilonEnd = 0.05f;        // to this over the run
+    uint64_t seed = 1;
+};
+
+// Tabular Q-learning on the step MDP of VecMazeEnv: getReward of the cell
+// entered (or the penalty of the one bumped into), ending at the goal.
+// Each cell's four action values sit together in one 16-byte row, indexed
+// by CellIndex, so a lookup or update touches a single cache line.
+//
+// Training runs options.agents epsilon-greedy episodes at once: every
+// agent picks from the table as it stood before the step, then the whole
+// batch of transitions is applied. Play is a MazePlayer built with this
+// policy, which never revisits a cell, so the loops a discounted reward
+// can favour in training do not show up in play.
+class QLearningPolicy : public MovePolicy {
+public:
+    explicit QLearningPolicy(const MazeEnvironment& env);
+
+    // Continues from the current table, so it can be called repeatedly
+    void train(const QLearningOptions& options = QLearningOptions());
+
+    float moveValue(CellIndex cell, Direction move) const override {
+        return table[cell].value[move];
+    }
+
+    // The move with the highest value, the lowest direction on ties
+    Direction greedyMove(CellIndex cell) const;
+
+    const MazeEnvironment& getEnvironment() const { return env; }
+    uint64_t getTrainedSteps() const { return trainedSteps; }
+
+private:
+    struct alignas(16) ActionValues {
+        float value[FOUR_CONNECTED] = {0, 0, 0, 0};
+    };
+
+    const MazeEnvironment& env;
+    vector<ActionValues> table; // one row per padded cell, border ring included
+    uint64_t trainedSteps = 0;
+
+    float bestValue(CellIndex cell) const;
+};
+
+#endif // MAZE_QLEARNING_HPP
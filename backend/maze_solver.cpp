@@ -0,0 +1,165 @@
+#include "maze_solver.hpp"
+#include <queue>
+
+MazeSolver::MazeSolver(const MazeEnvironment& env, pmr::memory_resource* memory)
+    : env(env), cols(env.getCols()), memory(memory),
+      parent(size_t(env.getRows()) * env.getCols(), memory), cost(memory), queue(64, memory) {}
+
+MazeSolution MazeSolver::solve(SolverMode mode) {
+    return solve(Position(0, 0), env.getGoal(), mode);
+}
+
+MazeSolution MazeSolver::solve(Position start, Position goal, SolverMode mode) {
+    MazeSolution solution;
+    if (env.getCell(start) < 0 || env.getCell(goal) < 0) {
+        return solution;
+    }
+    fill(parent.begin(), parent.end(), UNSEEN);
+    bool found = mode == SOLVER_ASTAR ? aStar(start, goal, solution)
+               : mode == SOLVER_FLOOD ? flood(start, goal, solution)
+               : bfs(start, goal, solution);
+    if (found) {
+        reconstruct(start, goal, solution);
+    }
+    return solution;
+}
+
+bool MazeSolver::bfs(Position start, Position goal, MazeSolution& solution) {
+    queue.clear();
+    queue.push(cellOf(start));
+    parent[cellOf(start)] = UP; // any value but UNSEEN; the start is never walked back from
+    uint32_t goalCell = cellOf(goal);
+
+    while (!queue.empty()) {
+        uint32_t cell = queue.pop();
+        solution.expanded++;
+        if (cell == goalCell) {
+            return true;
+        }
+        Position pos = positionOf(cell);
+        for (int dir = 0; dir < 4; dir++) {
+            if (!env.isValidMove(pos, static_cast<Direction>(dir))) {
+                continue;
+            }
+            uint32_t next = cellOf(env.getNextPosition(pos, static_cast<Direction>(dir)));
+            if (parent[next] == UNSEEN) {
+                parent[next] = uint8_t(dir);
+                queue.push(next);
+            }
+        }
+    }
+    return false;
+}
+
+bool MazeSolver::aStar(Position start, Position goal, MazeSolution& solution) {
+    // Frontier entries pack (f, h, cell) into one word so the heap compares
+    // plain integers: lowest f first, then the cell closest to the goal
+    auto heuristic = [&](Position pos) {
+        return uint64_t(abs(goal.x - pos.x) + abs(goal.y - pos.y));
+    };
+    auto pack = [](uint64_t f, uint64_t h, uint32_t cell) {
+        return (f << 37) | (h << 24) | cell;
+    };
+    const uint64_t cellMask = (uint64_t(1) << 24) - 1;
+
+    cost.assign(parent.size(), numeric_limits<int32_t>::max());
+    priority_queue<uint64_t, pmr::vector<uint64_t>, greater<uint64_t>> open{
+        greater<uint64_t>(), pmr::vector<uint64_t>(memory)};
+    uint32_t startCell = cellOf(start);
+    uint32_t goalCell = cellOf(goal);
+    cost[startCell] = 0;
+    parent[startCell] = UP;
+    open.push(pack(heuristic(start), heuristic(start), startCell));
+
+    while (!open.empty()) {
+        uint64_t entry = open.top();
+        open.pop();
+        uint32_t cell = uint32_t(entry & cellMask);
+        Position pos = positionOf(cell);
+        // Skip stale entries superseded by a cheaper path
+        if (uint64_t(cost[cell]) + heuristic(pos) != (entry >> 37)) {
+            continue;
+        }
+        solution.expanded++;
+        if (cell == goalCell) {
+            return true;
+        }
+        for (int dir = 0; dir < 4; dir++) {
+            if (!env.isValidMove(pos, static_cast<Direction>(dir))) {
+                continue;
+            }
+            Position nextPos = env.getNextPosition(pos, static_cast<Direction>(dir));
+            uint32_t next = cellOf(nextPos);
+            int32_t nextCost = cost[cell] + 1;
+            if (nextCost < cost[next]) {
+                cost[next] = nextCost;
+                parent[next] = uint8_t(dir);
+                uint64_t h = heuristic(nextPos);
+                open.push(pack(nextCost + h, h, next));
+            }
+        }
+    }
+    return false;
+}
+
+bool MazeSolver::flood(Position start, Position goal, MazeSolution& solution) {
+    // The environment keeps the field for its own goal; other targets get
+    // a one-off flood
+    vector<int32_t> otherGoal;
+    const vector<int32_t>& distance = goal == env.getGoal()
+        ? env.getGoalDistances() : (otherGoal = MazeBitboard(env).distanceField(goal));
+    solution.expanded = count_if(distance.begin(), distance.end(),
+                                 [](int32_t d) { return d != MazeBitboard::UNREACHABLE; });
+    if (distance[cellOf(start)] == MazeBitboard::UNREACHABLE) {
+        return false;
+    }
+
+    // Any neighbour one move closer to the goal continues a shortest path
+    Position pos = start;
+    while (!(pos == goal)) {
+        for (int dir = 0; dir < 4; dir++) {
+            if (!env.isValidMove(pos, static_cast<Direction>(dir))) {
+                continue;
+            }
+            Position next = env.getNextPosition(pos, static_cast<Direction>(dir));
+            if (distance[cellOf(next)] == distance[cellOf(pos)] - 1) {
+                parent[cellOf(next)] = uint8_t(dir);
+                pos = next;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+// Walks the parent directions back from the goal, then reverses. A first
+// walk only counts, so the path is allocated once.
+void MazeSolver::reconstruct(Position start, Position goal, MazeSolution& solution) const {
+    solution.found = true;
+    size_t length = 1;
+    for (Position pos = goal; !(pos == start); length++) {
+        pos = env.getNextPosition(pos, opposite(static_cast<Direction>(parent[cellOf(pos)])));
+    }
+    solution.path.reserve(length);
+    Position pos = goal;
+    while (!(pos == start)) {
+        solution.path.push_back(pos);
+        if (env.getCell(pos) > OPEN) {
+            solution.score += env.getCell(pos);
+        }
+        pos = env.getNextPosition(pos, opposite(static_cast<Direction>(parent[cellOf(pos)])));
+    }
+    solution.path.push_back(start);
+    reverse(solution.path.begin(), solution.path.end());
+}
+
+json solutionToNodeJson(const MazeSolution& solution) {
+    json path = json::array();
+    for (const auto& pos : solution.path) {
+        path.push_back({{"x", pos.y}, {"y", pos.x}});
+    }
+    return {{"path", path},
+            {"score", solution.score},
+            {"length", solution.path.size()},
+            {"expanded", solution.expanded}};
+}
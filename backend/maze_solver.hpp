@@ -0,0 +1,104 @@
+#ifndef MAZE_SOLVER_HPP
+#define MAZE_SOLVER_HPP
+
+#include "maze_bitboard.hpp"
+
+// Shortest-path solvers over a MazeEnvironment. Every mode finds a path
+// with the fewest moves; A* expands fewer cells on open grids, and FLOOD
+// runs a bit-parallel distance field from the goal (see MazeBitboard),
+// then walks down it from the start.
+enum SolverMode { SOLVER_BFS, SOLVER_ASTAR, SOLVER_FLOOD };
+
+inline SolverMode parseSolverMode(const string& name) {
+    if (name == "bfs") return SOLVER_BFS;
+    if (name == "astar") return SOLVER_ASTAR;
+    if (name == "flood") return SOLVER_FLOOD;
+    throw invalid_argument("Unknown solver mode: " + name);
+}
+
+struct MazeSolution {
+    bool found = false;
+    vector<Position> path;  // start to goal inclusive, empty if not found
+    int score = 0;          // sum of reward pickups along the path
+    long long expanded = 0; // cells taken off the frontier
+};
+
+// Solution in the Node server's convention: points are {x: column, y: row}
+json solutionToNodeJson(const MazeSolution& solution);
+
+// FIFO queue over a power-of-two circular buffer: pops are O(1) (no
+// shifting) and the buffer only grows when the frontier outgrows it
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 64, pmr::memory_resource* memory = pmr::get_default_resource())
+        : items(memory) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        items.resize(size);
+    }
+
+    bool empty() const { return head == tail; }
+    size_t size() const { return tail - head; }
+
+    void push(T item) {
+        if (size() == items.size()) {
+            grow();
+        }
+        items[tail++ & (items.size() - 1)] = item;
+    }
+
+    T pop() {
+        return items[head++ & (items.size() - 1)];
+    }
+
+    void clear() {
+        head = tail = 0;
+    }
+
+private:
+    pmr::vector<T> items;
+    size_t head = 0, tail = 0;
+
+    void grow() {
+        pmr::vector<T> larger(items.size() * 2, items.get_allocator());
+        for (size_t i = 0; i < size(); i++) {
+            larger[i] = items[(head + i) & (items.size() - 1)];
+        }
+        tail = size();
+        head = 0;
+        items.swap(larger);
+    }
+};
+
+// Keeps its per-cell scratch arrays between solves, so one solver can
+// answer many queries on the same maze without reallocating. The scratch
+// comes from memory, e.g. a MatchArena reset between requests.
+class MazeSolver {
+public:
+    explicit MazeSolver(const MazeEnvironment& env,
+                        pmr::memory_resource* memory = pmr::get_default_resource());
+
+    MazeSolution solve(SolverMode mode = SOLVER_BFS);
+    MazeSolution solve(Position start, Position goal, SolverMode mode = SOLVER_BFS);
+
+private:
+    static constexpr uint8_t UNSEEN = 0xFF;
+
+    const MazeEnvironment& env;
+    int cols;
+    pmr::memory_resource* memory;
+    pmr::vector<uint8_t> parent; // Direction used to enter each cell, or UNSEEN
+    pmr::vector<int32_t> cost;   // A* only: best known moves from the start
+    RingBuffer<uint32_t> queue;
+
+    uint32_t cellOf(Position pos) const { return uint32_t(pos.x) * cols + pos.y; }
+    Position positionOf(uint32_t cell) const { return Position(int(cell / cols), int(cell % cols)); }
+
+    bool bfs(Position start, Position goal, MazeSolution& solution);
+    bool aStar(Position start, Position goal, MazeSolution& solution);
+    bool flood(Position start, Position goal, MazeSolution& solution);
+    void reconstruct(Position start, Position goal, MazeSolution& solution) const;
+};
+
+#endif // MAZE_SOLVER_HPP
@@ -0,0 +1,40 @@
+// Standalone command-line front end for MazeSolver ("build solver" task),
+// for scripting and debugging solves outside the server. server/server.js
+// sends its solves to the api_server "solve" op instead, which takes the
+// same grid and answers in the same shape.
+//
+// Reads one JSON request from stdin:
+//   { "maze": [[0, -1, ...], ...], "mode": "bfs" | "astar" | "flood",
+//     "start": {"x": 0, "y": 0}, "end": {"x": 9, "y": 9} }
+// and writes { "path": [...], "score": n, "length": n, "expanded": n }.
+// Like the Node code, maze[y][x] is the cell at column x, row y; start and
+// end default to the top-left and bottom-right corners.
+
+#include "maze_solver.hpp"
+
+// Node {x: column, y: row} to engine (row, column)
+Position fromNode(const json& point) {
+    return Position(point.at("y").get<int>(), point.at("x").get<int>());
+}
+
+int main() {
+    try {
+        json request = json::parse(cin);
+        MazeEnvironment env(request.at("maze").get<vector<vector<int>>>());
+        SolverMode mode = parseSolverMode(request.value("mode", "bfs"));
+        Position start = request.contains("start") ? fromNode(request["start"]) : Position(0, 0);
+        Position goal = request.contains("end") ? fromNode(request["end"]) : env.getGoal();
+        if (start.x < 0 || start.x >= env.getRows() || start.y < 0 || start.y >= env.getCols() ||
+            goal.x < 0 || goal.x >= env.getRows() || goal.y < 0 || goal.y >= env.getCols()) {
+            throw invalid_argument("start and end must lie inside the maze");
+        }
+
+        MazeSolver solver(env);
+        MazeSolution solution = solver.solve(start, goal, mode);
+        cout << solutionToNodeJson(solution).dump() << "\n";
+        return 0;
+    } catch (const exception& error) {
+        cout << json{{"error", error.what()}}.dump() << "\n";
+        return 1;
+    }
+}
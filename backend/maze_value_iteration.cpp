@@ -0,0 +1,83 @@
+#include "maze_value_iteration.hpp"
+
+namespace {
+
+// One grid row of a sweep, on restrict pointers so the compiler knows the
+// new values cannot feed the old. Every move is the same load and add (see
+// moveValue), so the row has no branches to mispredict.
+uint32_t sweepRow(int cols, int goalCol, const array<int, EIGHT_CONNECTED>& offsets, float discount,
+                  float tolerance, const int32_t* __restrict reward, const float* __restrict old, float* __restrict out) {
+    const int up = offsets[UP], down = offsets[DOWN], left = offsets[LEFT], right = offsets[RIGHT];
+    uint32_t unsettled = 0;
+    for (int y = 0; y < cols; y++) {
+        auto moveValue = [&](int offset) {
+            return float(reward[y + offset]) + discount * old[y + offset];
+        };
+        float upDown = max(moveValue(up), moveValue(down));
+        float leftRight = max(moveValue(left), moveValue(right));
+        float best = max(upDown, leftRight);
+        // Walls are never entered and the goal is terminal: both stay 0
+        best *= float((reward[y] >= 0) & (y != goalCol));
+        out[y] = best;
+        unsettled += abs(best - old[y]) > tolerance;
+    }
+    return unsettled;
+}
+
+} // namespace
+
+ValueIterationPolicy::ValueIterationPolicy(const MazeEnvironment& env, const ValueIterationOptions& options)
+    : env(env), discount(options.discount), rewards(env.rewardTable()) {
+    if (!(options.discount >= 0 && options.discount < 1)) {
+        throw invalid_argument("discount must be in [0, 1)");
+    }
+    int rows = env.getRows();
+    int cols = env.getCols();
+    size_t padded = size_t(rows + 2) * (cols + 2);
+    values.assign(padded, 0.0f);
+    vector<float> next(padded, 0.0f);
+
+    size_t tiles = (rows + VALUE_TILE_ROWS - 1) / VALUE_TILE_ROWS;
+    int threads = options.threads != 0 ? options.threads
+        : size_t(rows) * cols >= (1 << 16) ? 0 : 1;
+    vector<uint32_t> tileUnsettled(tiles);
+    while (sweeps < options.maxSweeps && !converged) {
+        parallelFor(tiles, threads, [&](size_t tile) {
+            int firstRow = int(tile) * VALUE_TILE_ROWS;
+            tileUnsettled[tile] = sweepRows(firstRow, min(rows, firstRow + VALUE_TILE_ROWS),
+                                            options.tolerance, values.data(), next.data());
+        });
+        values.swap(next);
+        sweeps++;
+        converged = all_of(tileUnsettled.begin(), tileUnsettled.end(), [](uint32_t count) { return count == 0; });
+    }
+
+    policy.assign(padded, UP);
+    for (int x = 0; x < rows; x++) {
+        for (int y = 0; y < cols; y++) {
+            CellIndex cell = env.cellIndex(Position(x, y));
+            int best = UP;
+            for (int move = 1; move < FOUR_CONNECTED; move++) {
+                if (moveValue(cell, static_cast<Direction>(move)) >
+                    moveValue(cell, static_cast<Direction>(best))) {
+                    best = move;
+                }
+            }
+            policy[cell] = uint8_t(best);
+        }
+    }
+}
+
+uint32_t ValueIterationPolicy::sweepRows(int firstRow, int lastRow, float tolerance,
+                                         const float* oldValues, float* newValues) const {
+    const int cols = env.getCols();
+    const array<int, EIGHT_CONNECTED> offsets = moveOffsets(cols + 2);
+    const Position goal = env.getGoal();
+    uint32_t unsettled = 0;
+    for (int x = firstRow; x < lastRow; x++) {
+        CellIndex rowStart = env.cellIndex(Position(x, 0));
+        unsettled += sweepRow(cols, x == goal.x ? goal.y : -1, offsets, discount, tolerance,
+                              rewards.data() + rowStart, oldValues + rowStart, newValues + rowStart);
+    }
+    return unsettled;
+}
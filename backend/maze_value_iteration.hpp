@@ -0,0 +1,63 @@
+#ifndef MAZE_VALUE_ITERATION_HPP
+#define MAZE_VALUE_ITERATION_HPP
+
+#include "maze_environment.hpp"
+
+const int VALUE_TILE_ROWS = 16; // grid rows per unit of parallel work
+
+struct ValueIterationOptions {
+    float discount = 0.95f;
+    float tolerance = 1e-3f; // converged once no value moves more than this in a sweep
+    int maxSweeps = 100000;
+    int threads = 0;         // 0 = one per hardware thread on large mazes, 1 otherwise
+};
+
+// Optimal play on the grid MDP of getReward and isValidMove: a valid move
+// pays getReward of the cell entered, an invalid one pays the wall or
+// border penalty (see moveValue), and the goal ends the episode. Value
+// iteration finds V(cell) = max over moves of reward + discount * V(next);
+// a move's value, and the best move per cell, are then table reads, so a
+// MazePlayer given this policy plays in O(1) per move.
+//
+// Sweeps are Jacobi: every cell is updated from the previous sweep's
+// values, so the grid splits into bands of VALUE_TILE_ROWS rows that run
+// on separate threads with nothing shared but the read-only old values.
+// The two value buffers swap after each sweep rather than being copied.
+class ValueIterationPolicy : public MovePolicy {
+public:
+    // Solves on construction; env must outlive the policy
+    explicit ValueIterationPolicy(const MazeEnvironment& env,
+                                  const ValueIterationOptions& options = ValueIterationOptions());
+
+    // An invalid move is valued at its penalty alone, as if it ended the
+    // episode. From a cell with any way out that changes nothing: going
+    // back and forth pays at least 1 / (1 - discount), so a valid move
+    // always beats a bump either way. Only cells walled in on all four
+    // sides come out different, and nothing can reach those.
+    float moveValue(CellIndex cell, Direction move) const override {
+        CellIndex target = env.neighbour(cell, move);
+        return float(rewards[target]) + discount * values[target];
+    }
+
+    float getValue(CellIndex cell) const { return values[cell]; }
+    Direction bestMove(CellIndex cell) const { return static_cast<Direction>(policy[cell]); }
+
+    int getSweeps() const { return sweeps; }
+    bool hasConverged() const { return converged; }
+
+private:
+    const MazeEnvironment& env;
+    float discount;
+    vector<int32_t> rewards; // env.rewardTable()
+    vector<float> values;    // 0 on walls, the border and the goal
+    vector<uint8_t> policy;  // best Direction per cell
+    int sweeps = 0;
+    bool converged = false;
+
+    // One band of a sweep from oldValues into newValues; returns how many
+    // of its cells moved by more than tolerance
+    uint32_t sweepRows(int firstRow, int lastRow, float tolerance,
+                       const float* oldValues, float* newValues) const;
+};
+
+#endif // MAZE_VALUE_ITERATION_HPP
@@ -0,0 +1,49 @@
+#include "maze_vec_env.hpp"
+
+namespace {
+
+// The step loop on plain restrict pointers, so the compiler knows no store
+// feeds a later load. Everything is a select rather than a branch, and a
+// move's offset comes from the action bits instead of a table, so the loop
+// vectorizes wherever the target can gather the reward reads (e.g. -mavx2).
+void stepAgents(size_t count, const uint8_t* __restrict actions, const int32_t* __restrict cellRewards,
+                int32_t rowStep, CellIndex start, CellIndex goal, uint32_t maxSteps,
+                CellIndex* __restrict position, uint32_t* __restrict steps,
+                int32_t* __restrict stepRewards, uint8_t* __restrict dones) {
+    for (size_t i = 0; i < count; i++) {
+        // UP/DOWN move a row, LEFT/RIGHT a column; the low bit is the sign
+        int32_t action = actions[i] & 3;
+        int32_t magnitude = action < 2 ? rowStep : 1;
+        int32_t offset = (action & 1) ? magnitude : -magnitude;
+        CellIndex target = position[i] + CellIndex(offset);
+        int32_t reward = cellRewards[target];
+        CellIndex next = reward > 0 ? target : position[i];
+        uint32_t taken = steps[i] + 1;
+        uint8_t done = uint8_t((next == goal ? DONE_GOAL : RUNNING) |
+                               (taken >= maxSteps ? DONE_TRUNCATED : RUNNING));
+        stepRewards[i] = reward;
+        dones[i] = done;
+        position[i] = done ? start : next;
+        steps[i] = done ? 0 : taken;
+    }
+}
+
+} // namespace
+
+VecMazeEnv::VecMazeEnv(const MazeEnvironment& env, size_t agents, uint32_t maxEpisodeSteps)
+    : env(env), stride(env.getCols() + 2), start(env.cellIndex(Position(0, 0))),
+      goal(env.cellIndex(env.getGoal())),
+      maxEpisodeSteps(maxEpisodeSteps > 0 ? maxEpisodeSteps : 4u * env.getRows() * env.getCols()),
+      rewards(env.rewardTable()), cells(agents), episodeSteps(agents) {
+    reset();
+}
+
+void VecMazeEnv::reset() {
+    fill(cells.begin(), cells.end(), start);
+    fill(episodeSteps.begin(), episodeSteps.end(), 0);
+}
+
+void VecMazeEnv::step(const uint8_t* actions, int32_t* stepRewards, uint8_t* dones) {
+    stepAgents(cells.size(), actions, rewards.data(), stride, start, goal, maxEpisodeSteps,
+               cells.data(), episodeSteps.data(), stepRewards, dones);
+}
@@ -0,0 +1,59 @@
+#ifndef MAZE_VEC_ENV_HPP
+#define MAZE_VEC_ENV_HPP
+
+#include "maze_environment.hpp"
+
+// Bit flags for why an agent's episode ended on a step; 0 while it is
+// still running. Reaching the goal on the last allowed step sets both,
+// so test a flag with & rather than comparing with ==.
+enum StepDone : uint8_t {
+    RUNNING = 0,
+    DONE_GOAL = 1,
+    DONE_TRUNCATED = 2,
+    DONE_GOAL_TRUNCATED = DONE_GOAL | DONE_TRUNCATED
+};
+
+// Many agents on one maze, stepped together for training loops. Agent
+// state is one flat array per field, and step() is a single loop over
+// them with no branches and no per-agent calls.
+//
+// An action is a Direction. Moving into a wall or the border leaves the
+// agent in place and pays that cell's getReward penalty; otherwise the
+// reward is getReward of the cell entered, as in MazePlayer::playMaze.
+// An episode ends on reaching the goal or after maxEpisodeSteps steps,
+// and that agent starts over at (0, 0) on the same step (auto-reset), so
+// its observation is already the first of the next episode.
+class VecMazeEnv {
+public:
+    // maxEpisodeSteps 0 = 4 * rows * cols, the playMaze default
+    VecMazeEnv(const MazeEnvironment& env, size_t agents, uint32_t maxEpisodeSteps = 0);
+
+    size_t size() const { return cells.size(); }
+    const MazeEnvironment& getEnvironment() const { return env; }
+
+    // Every agent back to (0, 0) at step 0
+    void reset();
+
+    // actions, rewards and dones hold size() entries each; dones are
+    // StepDone flags
+    void step(const uint8_t* actions, int32_t* rewards, uint8_t* dones);
+
+    // Observations: each agent's CellIndex (MazeEnvironment::positionOf
+    // turns one back into a Position) and steps into its episode
+    const CellIndex* getCells() const { return cells.data(); }
+    const uint32_t* getEpisodeSteps() const { return episodeSteps.data(); }
+
+private:
+    const MazeEnvironment& env;
+    int stride;
+    CellIndex start;
+    CellIndex goal;
+    uint32_t maxEpisodeSteps;
+    // getReward of every cell, border ring included; positive exactly
+    // where the cell can be entered
+    vector<int32_t> rewards;
+    vector<CellIndex> cells;
+    vector<uint32_t> episodeSteps;
+};
+
+#endif // MAZE_VEC_ENV_HPP
@@ -0,0 +1,171 @@
+// Round-trip and layout checks for the packed formats server/server.js
+// decodes by hand (unpackMaze, unpackBatchResults, unpackBracket): a
+// change to an offset here has to change there too. Exits non-zero on
+// any failure.
+//   g++ -O2 -std=c++17 -pthread -o build/packed_test.exe backend/packed_format_test.cpp backend/maze_environment.cpp backend/maze_bitboard.cpp backend/maze_batch.cpp backend/bracket_generator.cpp
+#include "maze_environment.hpp"
+#include "maze_batch.hpp"
+#include "bracket_generator.hpp"
+#include <iostream>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const string& what) {
+    if (!condition) {
+        cerr << "FAIL: " << what << "\n";
+        failures++;
+    }
+}
+
+template <typename Body>
+bool throwsInvalidArgument(Body body) {
+    try {
+        body();
+    } catch (const invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+bool sameMaze(const MazeEnvironment& a, const MazeEnvironment& b) {
+    if (a.getRows() != b.getRows() || a.getCols() != b.getCols() || a.getSeed() != b.getSeed() ||
+        a.getParams().generator != b.getParams().generator ||
+        a.getParams().wallDensity != b.getParams().wallDensity ||
+        a.getParams().loopDensity != b.getParams().loopDensity) {
+        return false;
+    }
+    for (int x = 0; x < a.getRows(); x++) {
+        for (int y = 0; y < a.getCols(); y++) {
+            if (a.getCell(Position(x, y)) != b.getCell(Position(x, y))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+MazeEnvironment unpack(const vector<uint8_t>& packed) {
+    return MazeEnvironment::fromPacked(packed.data(), packed.size());
+}
+
+void testMazeRoundTrip() {
+    for (MazeGenerator generator : {RANDOM_WALLS, CORRIDOR, SPANNING_TREE}) {
+        MazeParams params;
+        params.generator = generator;
+        params.loopDensity = 0.25;
+        for (int size : {2, 7, 33}) {
+            MazeEnvironment env(size, size + 3, 0x123456789ABCDEFull, params);
+            vector<uint8_t> packed = env.toPacked();
+            check(sameMaze(unpack(packed), env), string("round trip of a ") + generatorName(generator) + " maze");
+        }
+    }
+}
+
+// unpackMaze reads the header at these fixed offsets
+void testMazeLayout() {
+    // 3 x 3, cells row-major: 0..2, 3..5, 6..8
+    MazeEnvironment env(vector<vector<int>>{{0, 3, -1}, {0, 15, 0}, {-1, 0, 1}});
+    vector<uint8_t> packed = env.toPacked();
+    check(PACKED_HEADER_BYTES == 36, "the header is 36 bytes");
+    check(packed.size() == PACKED_HEADER_BYTES + 2 + 5, "header, 9 wall bits in 2 bytes, 9 nibbles in 5 bytes");
+    check(string(packed.begin(), packed.begin() + 4) == "MZB1", "magic at 0");
+    check(packed[4] == PACKED_MAZE_VERSION, "version at 4");
+    check(packed[5] == PACKED_HAS_REWARDS, "reward flag at 5");
+    check(getLittleEndian<uint16_t>(&packed[8]) == 3 && getLittleEndian<uint16_t>(&packed[10]) == 3,
+          "rows at 8, cols at 10");
+    check(getLittleEndian<uint64_t>(&packed[12]) == env.getSeed(), "seed at 12");
+
+    const uint8_t* walls = &packed[PACKED_HEADER_BYTES];
+    check(walls[0] == (1 << 2 | 1 << 6) && walls[1] == 0, "wall bit i % 8 of byte i / 8");
+    const uint8_t* rewards = walls + 2;
+    check(rewards[0] == 0x30, "cell 0 in the low nibble, cell 1 in the high one");
+    check(rewards[2] == 0x0F && rewards[4] == 0x01, "cells 4 and 8 in low nibbles");
+    check(sameMaze(unpack(packed), env), "round trip of a grid with rewards");
+
+    MazeEnvironment plain(vector<vector<int>>{{0, -1}, {0, 0}});
+    check(plain.toPacked().size() == PACKED_HEADER_BYTES + 1 && plain.toPacked()[5] == 0,
+          "no reward plane without rewards");
+}
+
+void testMazeValidation() {
+    vector<uint8_t> packed = MazeEnvironment(5, 5, 9).toPacked();
+    auto corrupt = [&](size_t offset, uint8_t value) {
+        vector<uint8_t> copy = packed;
+        copy[offset] = value;
+        return copy;
+    };
+    check(throwsInvalidArgument([&] { unpack(corrupt(0, 'X')); }), "wrong magic");
+    check(throwsInvalidArgument([&] { unpack(corrupt(4, PACKED_MAZE_VERSION + 1)); }), "unknown version");
+    check(throwsInvalidArgument([&] { unpack(corrupt(6, SPANNING_TREE + 1)); }), "unknown generator");
+    check(throwsInvalidArgument([&] { unpack(vector<uint8_t>(packed.begin(), packed.end() - 1)); }),
+          "truncated wall plane");
+}
+
+// unpackBatchResults reads the columns in this order
+void testBatchLayout() {
+    BatchResults results;
+    results.firstPlayer = {0, 2, 3};
+    results.totalReward = {-5, 7, 100000};
+    results.steps = {1, 2, 3};
+    results.revisits = {4, 5, 6};
+    results.searchNodes = {uint64_t(1) << 40, 8, 9};
+    results.termination = {GOAL_REACHED, STEP_LIMIT, GOAL_UNREACHABLE};
+    vector<uint8_t> packed = results.toPacked();
+    size_t rows = 3;
+    check(packed.size() == BATCH_RESULTS_HEADER_BYTES + 4 * 3 + (4 + 4 + 4 + 8 + 1) * rows, "batch size");
+    check(string(packed.begin(), packed.begin() + 4) == "MZR1", "batch magic");
+    check(getLittleEndian<uint32_t>(&packed[4]) == 2 && getLittleEndian<uint32_t>(&packed[8]) == 3,
+          "jobs at 4, rows at 8");
+    size_t offset = BATCH_RESULTS_HEADER_BYTES;
+    check(getLittleEndian<uint32_t>(&packed[offset + 4]) == 2, "firstPlayer after the header");
+    offset += 4 * 3;
+    check(getLittleEndian<int32_t>(&packed[offset]) == -5, "totalReward next");
+    offset += 4 * rows;
+    check(getLittleEndian<uint32_t>(&packed[offset + 8]) == 3, "then steps");
+    offset += 4 * rows;
+    check(getLittleEndian<uint32_t>(&packed[offset]) == 4, "then revisits");
+    offset += 4 * rows;
+    check(getLittleEndian<uint64_t>(&packed[offset]) == uint64_t(1) << 40, "then searchNodes");
+    offset += 8 * rows;
+    check(packed[offset + 2] == GOAL_UNREACHABLE, "then termination");
+}
+
+// unpackBracket reads node m at byte 12 + 4 * m
+void testBracketLayout() {
+    Bracket bracket(5); // byes decided, one real first-round match reported
+    uint32_t playable = 4;
+    while (bracket.isBye(bracket.getSeed(2 * playable + 1))) {
+        playable++;
+    }
+    bracket.reportResult(playable, bracket.getSeed(2 * playable + 1));
+    vector<uint8_t> packed = bracket.toPacked();
+    uint32_t slots = bracket.getSlots();
+    check(packed.size() == PACKED_BRACKET_HEADER_BYTES + 4 * 2 * slots, "bracket size");
+    check(string(packed.begin(), packed.begin() + 4) == "BRK1", "bracket magic");
+    check(getLittleEndian<uint32_t>(&packed[4]) == 5 && getLittleEndian<uint32_t>(&packed[8]) == slots,
+          "entrants at 4, slots at 8");
+    bool sameNodes = true;
+    for (uint32_t node = 1; node < 2 * slots; node++) {
+        uint32_t seed = getLittleEndian<uint32_t>(&packed[PACKED_BRACKET_HEADER_BYTES + 4 * node]);
+        sameNodes &= seed == bracket.getSeed(node);
+    }
+    check(sameNodes, "every node's seed, NO_SEED (0) when undecided");
+}
+
+} // namespace
+
+int main() {
+    testMazeRoundTrip();
+    testMazeLayout();
+    testMazeValidation();
+    testBatchLayout();
+    testBracketLayout();
+    if (failures > 0) {
+        cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    cout << "packed format tests passed\n";
+    return 0;
+}
@@ -3,7 +3,8 @@ const cors = require('cors');
 const bodyParser = require('body-parser');
 const path = require('path');
 const seedrandom = require('seedrandom');
-const { exec } = require('child_process');
+const { exec, spawn } = require('child_process');
+const EventEmitter = require('events');
 const fs = require('fs');
 
 const app = express();
@@ -12,7 +13,7 @@ const PORT = process.env.PORT || 3001;
 // Enable CORS for all routes
 app.use(cors({
     origin: '*', // Allow all origins for development
-    methods: ['GET', 'POST', 'OPTIONS'],
+    methods: ['GET', 'POST', 'PUT', 'DELETE', 'OPTIONS'],
     allowedHeaders: ['Content-Type', 'Authorization'],
     credentials: true
 }));
@@ -40,7 +41,7 @@ app.use((req, res, next) => {
 });
 
 // --- MAZE GENERATION ---
-function generateMaze(size = 10, seed = null) {
+async function generateMaze(size = 10, seed = null) {
     try {
         const rng = seed ? new seedrandom(seed) : Math.random;
         const maze = Array(size).fill().map(() => Array(size).fill(0));
@@ -69,10 +70,10 @@ function generateMaze(size = 10, seed = null) {
         }
         
         // Ensure there's always a valid path from start to end
-        const solution = solveMaze(maze);
+        const solution = await solveMaze(maze);
         if (solution.path.length === 0) {
             console.log('No valid path found, regenerating maze...');
-            return generateMaze(size, seed ? seed + 'retry' : null);
+            return await generateMaze(size, seed ? seed + 'retry' : null);
         }
         
         return {
@@ -88,56 +89,83 @@ function generateMaze(size = 10, seed = null) {
 }
 
 // --- PATHFINDING ---
-function solveMaze(maze) {
+// Large mazes go to the native maze service's BFS/A* solver (see below),
+// which is already running, so a solve costs one framed round trip
+// instead of a process spawn. Small mazes stay in JS, where the JSON
+// encoding would cost more than the search.
+const NATIVE_SOLVER_MIN_CELLS = 64 * 64;
+
+async function solveMaze(maze, mode = 'bfs') {
+    const cells = maze.length * (maze[0] ? maze[0].length : 0);
+    if (cells >= NATIVE_SOLVER_MIN_CELLS && nativeService.isAvailable()) {
+        try {
+            const result = await nativeService.request({ op: 'solve', grid: maze, mode });
+            return { path: result.path, score: result.score, length: result.length };
+        } catch (error) {
+            console.error('Native solver failed, falling back to JS:', error.message);
+        }
+    }
+    return solveMazeJS(maze);
+}
+
+// Scratch for solveMazeJS, kept between calls and grown on demand, so a
+// solve allocates no per-cell objects: the queue holds cell indices
+// (y * size + x) and each cell remembers the direction it was entered by.
+let solverQueue = new Int32Array(0);
+let solverParent = new Int8Array(0);
+const SOLVER_DIRECTIONS = [
+    { dx: 1, dy: 0 },  // right
+    { dx: -1, dy: 0 }, // left
+    { dx: 0, dy: 1 },  // down
+    { dx: 0, dy: -1 }  // up
+];
+
+function solveMazeJS(maze) {
     try {
         const size = maze.length;
-        const queue = [{ x: 0, y: 0, path: [{x: 0, y: 0}], score: 0 }];
-        const visited = new Set(['0,0']);
-        
-        const directions = [
-            { dx: 1, dy: 0 },  // right
-            { dx: -1, dy: 0 }, // left
-            { dx: 0, dy: 1 },  // down
-            { dx: 0, dy: -1 }  // up
-        ];
-        
-        while (queue.length > 0) {
-            const current = queue.shift();
-            
+        const cells = size * size;
+        if (cells === 0) {
+            return { path: [], score: 0, length: 0 };
+        }
+        if (solverQueue.length < cells) {
+            solverQueue = new Int32Array(cells);
+            solverParent = new Int8Array(cells);
+        }
+        const queue = solverQueue;
+        const parent = solverParent;
+        parent.fill(-1, 0, cells);
+
+        const goal = cells - 1;
+        let head = 0;
+        let tail = 0;
+        queue[tail++] = 0;
+        parent[0] = SOLVER_DIRECTIONS.length; // any direction; the start is never walked back from
+
+        while (head < tail) {
+            const cell = queue[head++];
+
             // Check if we've reached the end
-            if (current.x === size - 1 && current.y === size - 1) {
-                return {
-                    path: current.path,
-                    score: current.score,
-                    length: current.path.length
-                };
+            if (cell === goal) {
+                return solverPath(maze, size, goal);
             }
-            
+
             // Explore all directions
-            for (const dir of directions) {
-                const newX = current.x + dir.dx;
-                const newY = current.y + dir.dy;
-                const key = `${newX},${newY}`;
-                
-                // Check if move is valid
-                if (newX >= 0 && newX < size && newY >= 0 && newY < size && 
-                    maze[newY][newX] !== -1 && !visited.has(key)) {
-                    
-                    visited.add(key);
-                    
-                    // Calculate new score (add reward if present)
-                    const reward = maze[newY][newX] > 0 ? maze[newY][newX] : 0;
-                    
-                    queue.push({
-                        x: newX,
-                        y: newY,
-                        path: [...current.path, { x: newX, y: newY }],
-                        score: current.score + reward
-                    });
+            const x = cell % size;
+            const y = (cell - x) / size;
+            for (let d = 0; d < SOLVER_DIRECTIONS.length; d++) {
+                const newX = x + SOLVER_DIRECTIONS[d].dx;
+                const newY = y + SOLVER_DIRECTIONS[d].dy;
+                if (newX >= 0 && newX < size && newY >= 0 && newY < size &&
+                    maze[newY][newX] !== -1) {
+                    const next = newY * size + newX;
+                    if (parent[next] === -1) {
+                        parent[next] = d;
+                        queue[tail++] = next;
+                    }
                 }
             }
         }
-        
+
         return { path: [], score: 0, length: 0 }; // No path found
     } catch (error) {
         console.error('Error in solveMaze:', error);
@@ -145,6 +173,24 @@ function solveMaze(maze) {
     }
 }
 
+// Walks solverParent back from the goal; the score counts every reward
+// after the start
+function solverPath(maze, size, goal) {
+    const path = [];
+    let score = 0;
+    for (let cell = goal; cell !== 0;) {
+        const x = cell % size;
+        const y = (cell - x) / size;
+        path.push({ x, y });
+        if (maze[y][x] > 0) score += maze[y][x];
+        const dir = SOLVER_DIRECTIONS[solverParent[cell]];
+        cell -= dir.dy * size + dir.dx;
+    }
+    path.push({ x: 0, y: 0 });
+    path.reverse();
+    return { path, score, length: path.length };
+}
+
 // --- TOURNAMENT BRACKET ---
 function generateBracket(players) {
     try {
@@ -240,7 +286,7 @@ function generateBracket(players) {
             rounds: matches,
             winner: currentRound[0]?.winner?.name || 'No winner'
         };
-        console.log('Generated bracket:', JSON.stringify(result, null, 2));
+        console.log(`Generated bracket: ${numPlayers} players, ${matches.length} rounds, winner ${result.winner}`);
         return result;
     } catch (error) {
         console.error('Error in generateBracket:', error);
@@ -248,6 +294,222 @@ function generateBracket(players) {
     }
 }
 
+// --- NATIVE MAZE SERVICE ---
+// The build tasks name their output name.exe on every platform (g++ on
+// Linux or macOS runs it just the same); a binary built without the
+// suffix is found too. Looked up on each use, so a build made while the
+// server runs is picked up.
+function nativeBinary(name) {
+    const candidates = [name + '.exe', name].map(file => path.join(__dirname, '../build', file));
+    return candidates.find(file => fs.existsSync(file)) || candidates[0];
+}
+
+// Long-lived backend/api_server.cpp process ("build api" task) that keeps
+// mazes and search caches warm. Frames on its stdin/stdout are a 4-byte
+// little-endian payload length, a 1-byte encoding and the payload: JSON, or
+// for { op: 'maze' | 'batch' | 'bracket', format: 'packed' } a 4-byte
+// request id plus the packed maze, batch results or bracket.
+const NATIVE_SERVICE = 'api_server';
+const FRAME_HEADER_BYTES = 5;
+const FRAME_JSON = 0;
+const FRAME_PACKED_MAZE = 2;
+const FRAME_BATCH_RESULTS = 3;
+const FRAME_PACKED_BRACKET = 4;
+
+// Decodes MazeEnvironment::toPacked output (see maze_environment.hpp):
+// a 36-byte header, one wall bit per cell, then optional reward nibbles
+function unpackMaze(buffer) {
+    if (buffer.toString('latin1', 0, 4) !== 'MZB1') {
+        throw new Error('Not a packed maze');
+    }
+    const hasRewards = (buffer.readUInt8(5) & 1) !== 0;
+    const rows = buffer.readUInt16LE(8);
+    const cols = buffer.readUInt16LE(10);
+    const seed = buffer.readBigUInt64LE(12).toString();
+    const walls = 36;
+    const rewards = walls + Math.ceil(rows * cols / 8);
+    const grid = new Array(rows);
+    for (let i = 0, cell = 0; i < rows; i++) {
+        const row = new Array(cols);
+        for (let j = 0; j < cols; j++, cell++) {
+            if ((buffer[walls + (cell >> 3)] >> (cell & 7)) & 1) {
+                row[j] = -1;
+            } else {
+                row[j] = hasRewards ? (buffer[rewards + (cell >> 1)] >> (4 * (cell & 1))) & 0xF : 0;
+            }
+        }
+        grid[i] = row;
+    }
+    return { grid, rows, cols, seed };
+}
+
+// Decodes BatchResults::toPacked output (see maze_batch.hpp) into one
+// typed array per column; each array is copied out so it is aligned
+const TERMINATION_NAMES = ['goal_reached', 'step_limit', 'deadline', 'cancelled', 'goal_unreachable'];
+
+function unpackBatchResults(buffer) {
+    if (buffer.toString('latin1', 0, 4) !== 'MZR1') {
+        throw new Error('Not packed batch results');
+    }
+    const jobs = buffer.readUInt32LE(4);
+    const rows = buffer.readUInt32LE(8);
+    let offset = 12;
+    const column = (Type, count) => {
+        const bytes = buffer.subarray(offset, offset + count * Type.BYTES_PER_ELEMENT);
+        offset += bytes.length;
+        return new Type(new Uint8Array(bytes).buffer);
+    };
+    const firstPlayer = column(Uint32Array, jobs + 1);
+    const totalReward = column(Int32Array, rows);
+    const steps = column(Uint32Array, rows);
+    const revisits = column(Uint32Array, rows);
+    const searchNodes = column(BigUint64Array, rows);
+    const termination = column(Uint8Array, rows);
+    return {
+        first_player: Array.from(firstPlayer),
+        total_reward: Array.from(totalReward),
+        steps: Array.from(steps),
+        revisits: Array.from(revisits),
+        search_nodes: Array.from(searchNodes, Number),
+        termination: Array.from(termination, reason => TERMINATION_NAMES[reason])
+    };
+}
+
+// Decodes Bracket::toPacked output (see bracket_generator.hpp): the flat
+// tree where node 1 is the final and node m is fed by 2m and 2m + 1
+function unpackBracket(buffer) {
+    if (buffer.toString('latin1', 0, 4) !== 'BRK1') {
+        throw new Error('Not a packed bracket');
+    }
+    const entrants = buffer.readUInt32LE(4);
+    const slots = buffer.readUInt32LE(8);
+    const nodes = new Uint32Array(new Uint8Array(buffer.subarray(12, 12 + 8 * slots)).buffer);
+    return { entrants, slots, nodes };
+}
+
+// Lays a packed bracket out like generateBracket; names[i] is seed i + 1.
+// Seeds past the entrant count are byes. Each match also gets its node
+// number as `match`, which live result updates refer to.
+function bracketFromTree(names, { entrants, slots, nodes }) {
+    const players = names.map((name, index) => ({ name, seed: index + 1 }));
+    const player = seed => (seed === 0 || seed > entrants ? null : players[seed - 1]);
+    const rounds = [];
+    for (let round = 1, first = slots >> 1; first >= 1; round++, first >>= 1) {
+        const matches = new Array(first);
+        for (let i = 0; i < first; i++) {
+            const match = first + i;
+            matches[i] = {
+                match,
+                player1: player(nodes[2 * match]),
+                player2: player(nodes[2 * match + 1]),
+                winner: player(nodes[match]),
+                round
+            };
+        }
+        rounds.push(matches);
+    }
+    const winner = player(nodes[1]);
+    return { players, rounds, winner: winner ? winner.name : 'No winner' };
+}
+
+function unpackFrame(encoding, payload) {
+    if (encoding === FRAME_PACKED_MAZE) {
+        return { id: payload.readUInt32LE(0), ok: true, result: unpackMaze(payload.subarray(4)) };
+    }
+    if (encoding === FRAME_BATCH_RESULTS) {
+        return { id: payload.readUInt32LE(0), ok: true, result: unpackBatchResults(payload.subarray(4)) };
+    }
+    if (encoding === FRAME_PACKED_BRACKET) {
+        return { id: payload.readUInt32LE(0), ok: true, result: unpackBracket(payload.subarray(4)) };
+    }
+    return JSON.parse(payload.toString('utf8'));
+}
+
+// Emits 'stop' whenever a running service goes away
+class NativeMazeService extends EventEmitter {
+    constructor(name) {
+        super();
+        this.name = name;
+        this.child = null;
+        this.nextId = 1;
+        this.pending = new Map();
+        this.buffer = Buffer.alloc(0);
+    }
+
+    isAvailable() {
+        return fs.existsSync(nativeBinary(this.name));
+    }
+
+    start() {
+        if (this.child) return;
+        const child = spawn(nativeBinary(this.name), [], { stdio: ['pipe', 'pipe', 'inherit'] });
+        this.child = child;
+        this.buffer = Buffer.alloc(0);
+        child.stdout.on('data', chunk => this.onData(chunk));
+        // A failed spawn (e.g. EACCES) and a write to a service that has
+        // died before 'exit' fires (EPIPE) arrive as 'error' events, which
+        // would otherwise take the whole server down
+        child.on('error', error => this.stop(child, error));
+        child.stdin.on('error', error => this.stop(child, error));
+        child.on('exit', code => this.stop(child, new Error(`Native maze service exited with code ${code}`)));
+    }
+
+    // Rejects everything in flight on child and forgets it, so the next
+    // request starts a fresh service. Only the first call per child acts.
+    stop(child, error) {
+        if (this.child !== child) return;
+        this.child = null;
+        child.kill();
+        console.error(`Native maze service stopped: ${error.message}`);
+        for (const { reject } of this.pending.values()) {
+            reject(error);
+        }
+        this.pending.clear();
+        this.emit('stop');
+    }
+
+    // onPartial, if given, receives each partial result of a streamed
+    // request before the promise resolves with the final one
+    request(body, onPartial) {
+        this.start();
+        const id = this.nextId++;
+        const payload = Buffer.from(JSON.stringify({ ...body, id }), 'utf8');
+        const header = Buffer.alloc(FRAME_HEADER_BYTES);
+        header.writeUInt32LE(payload.length, 0);
+        header.writeUInt8(FRAME_JSON, 4);
+        return new Promise((resolve, reject) => {
+            this.pending.set(id, { resolve, reject, onPartial });
+            this.child.stdin.write(Buffer.concat([header, payload]));
+        });
+    }
+
+    onData(chunk) {
+        this.buffer = Buffer.concat([this.buffer, chunk]);
+        while (this.buffer.length >= FRAME_HEADER_BYTES) {
+            const length = this.buffer.readUInt32LE(0);
+            if (this.buffer.length < FRAME_HEADER_BYTES + length) break;
+            const encoding = this.buffer.readUInt8(4);
+            const payload = this.buffer.subarray(FRAME_HEADER_BYTES, FRAME_HEADER_BYTES + length);
+            this.buffer = this.buffer.subarray(FRAME_HEADER_BYTES + length);
+            const response = unpackFrame(encoding, payload);
+            const entry = this.pending.get(response.id);
+            if (!entry) continue;
+            if (response.partial) {
+                if (entry.onPartial) entry.onPartial(response.result);
+                continue;
+            }
+            this.pending.delete(response.id);
+            if (response.ok) {
+                entry.resolve(response.result);
+            } else {
+                entry.reject(new Error(response.error));
+            }
+        }
+    }
+}
+
+const nativeService = new NativeMazeService(NATIVE_SERVICE);
+
 // --- SIMULATION ---
 async function simulatePlayer(playerName, maze) {
     try {
@@ -255,7 +517,7 @@ async function simulatePlayer(playerName, maze) {
         const startTime = Date.now();
         
         // Use the solution path to ensure we always have a valid path
-        const solution = solveMaze(maze.grid);
+        const solution = await solveMaze(maze.grid);
         
         // Add some randomness to the path and score
         const pathLength = solution.path.length;
@@ -314,7 +576,10 @@ function treeToRounds(root) {
     return rounds.reverse(); // So first round is first in array
 }
 
-// API endpoint for generating brackets
+// API endpoint for generating brackets: the native service's "bracket" op
+// (backend/bracket_generator.cpp) when it is built, generateBracket
+// otherwise. The service sends the tree packed and it is laid out here,
+// where the names already are.
 app.post('/api/bracket', async (req, res) => {
     try {
         const { players } = req.body;
@@ -326,7 +591,21 @@ app.post('/api/bracket', async (req, res) => {
             });
         }
 
-        const bracket = generateBracket(players);
+        if (req.body.live) {
+            if (!nativeService.isAvailable()) {
+                return res.status(503).json({ success: false, error: 'Live brackets need the native maze service' });
+            }
+            return res.json({ success: true, ...(await openLiveBracket(players)) });
+        }
+
+        let bracket;
+        if (nativeService.isAvailable()) {
+            const names = players.map(name => String(name).trim());
+            const tree = await nativeService.request({ op: 'bracket', entrants: names.length, format: 'packed' });
+            bracket = bracketFromTree(names, tree);
+        } else {
+            bracket = generateBracket(players);
+        }
         
         res.json({
             success: true,
@@ -341,14 +620,209 @@ app.post('/api/bracket', async (req, res) => {
     }
 });
 
+// --- LIVE BRACKETS ---
+// A bracket opened with { live: true } stays in the native service; each
+// reported result changes only the matches on its path to the final, and
+// that delta goes to the reporter and to every /events subscriber instead
+// of a whole new bracket. A bracket nobody has reported to or watched for
+// LIVE_BRACKET_IDLE_MS is closed; the service also closes its least
+// recently used bracket once it holds MAX_LIVE_BRACKETS (api_server.cpp).
+const liveBrackets = new Map(); // bracketId -> { names, subscribers, lastUsed }
+const LIVE_BRACKET_IDLE_MS = 60 * 60 * 1000;
+
+function closeLiveBracket(bracketId) {
+    const live = liveBrackets.get(bracketId);
+    liveBrackets.delete(bracketId);
+    if (live) {
+        for (const subscriber of live.subscribers) subscriber.end();
+    }
+}
+
+// A restarted service numbers its brackets from 1 again, so an old id
+// would report into someone else's bracket: every live bracket ends with
+// the process that held it
+nativeService.on('stop', () => {
+    for (const bracketId of [...liveBrackets.keys()]) {
+        closeLiveBracket(bracketId);
+    }
+});
+
+setInterval(() => {
+    const now = Date.now();
+    for (const [bracketId, live] of liveBrackets) {
+        if (live.subscribers.size === 0 && now - live.lastUsed > LIVE_BRACKET_IDLE_MS) {
+            closeLiveBracket(bracketId);
+            nativeService.request({ op: 'bracket_close', bracket_id: bracketId }).catch(() => {});
+        }
+    }
+}, 60 * 1000).unref();
+
+function deltaWithNames(live, delta) {
+    const player = seed => (seed === null ? null : { name: live.names[seed - 1], seed });
+    return {
+        version: delta.version,
+        changes: delta.changes.map(change => ({ ...change, winner: player(change.winner) }))
+    };
+}
+
+async function openLiveBracket(players) {
+    const names = players.map(name => String(name).trim());
+    const { bracket_id: bracketId, version } =
+        await nativeService.request({ op: 'bracket_open', entrants: names.length });
+    const tree = await nativeService.request({ op: 'bracket', bracket_id: bracketId, format: 'packed' });
+    liveBrackets.set(bracketId, { names, subscribers: new Set(), lastUsed: Date.now() });
+    return { bracketId, version, bracket: bracketFromTree(names, tree) };
+}
+
+// Body: { bracketId, match, winner } with winner a seed, or null to clear
+app.put('/api/bracket/match', async (req, res) => {
+    const { bracketId, match, winner = null } = req.body;
+    const live = liveBrackets.get(bracketId);
+    if (!live) {
+        return res.status(404).json({ success: false, error: 'No such live bracket' });
+    }
+    live.lastUsed = Date.now();
+    try {
+        const delta = deltaWithNames(live, await nativeService.request({
+            op: 'bracket_result', bracket_id: bracketId, match, winner
+        }));
+        if (delta.changes.length > 0) {
+            const event = `data: ${JSON.stringify({ bracketId, ...delta })}\n\n`;
+            for (const subscriber of live.subscribers) subscriber.write(event);
+        }
+        res.json({ success: true, bracketId, ...delta });
+    } catch (error) {
+        if (error.message.startsWith('No live bracket')) {
+            // Evicted by the service to make room for newer brackets
+            closeLiveBracket(bracketId);
+            return res.status(404).json({ success: false, error: 'No such live bracket' });
+        }
+        res.status(400).json({ success: false, error: error.message });
+    }
+});
+
+// Server-sent events: one { bracketId, version, changes } per result
+app.get('/api/bracket/:id/events', (req, res) => {
+    const live = liveBrackets.get(Number(req.params.id));
+    if (!live) {
+        return res.status(404).json({ success: false, error: 'No such live bracket' });
+    }
+    res.writeHead(200, {
+        'Content-Type': 'text/event-stream',
+        'Cache-Control': 'no-cache',
+        Connection: 'keep-alive'
+    });
+    res.write(': subscribed\n\n');
+    live.subscribers.add(res);
+    live.lastUsed = Date.now();
+    req.on('close', () => {
+        live.subscribers.delete(res);
+        live.lastUsed = Date.now();
+    });
+});
+
+app.delete('/api/bracket/:id', async (req, res) => {
+    const bracketId = Number(req.params.id);
+    const live = liveBrackets.get(bracketId);
+    if (!live) {
+        return res.status(404).json({ success: false, error: 'No such live bracket' });
+    }
+    closeLiveBracket(bracketId);
+    try {
+        await nativeService.request({ op: 'bracket_close', bracket_id: bracketId });
+        res.json({ success: true });
+    } catch (error) {
+        if (error.message.startsWith('No live bracket')) {
+            return res.json({ success: true }); // the service had already evicted it
+        }
+        res.status(500).json({ success: false, error: error.message });
+    }
+});
+
+// --- NATIVE TOURNAMENT ENDPOINT ---
+// Body: { players, size | rows/cols, seed, generator, search, max_steps, ... }
+// is forwarded as is to the native service's "tournament" op. With
+// "stream": true the response is NDJSON: one line per player as it
+// finishes, then a summary line { done: true, seed, players }.
+app.post('/api/native/tournament', async (req, res) => {
+    if (!nativeService.isAvailable()) {
+        return res.status(503).json({ success: false, error: 'Native maze service is not built' });
+    }
+    const { players } = req.body;
+    const validation = validatePlayers(players);
+    if (!validation.valid) {
+        return res.status(400).json({ success: false, error: validation.error });
+    }
+    if (req.body.stream) {
+        res.type('application/x-ndjson');
+        const writeLine = value => res.write(JSON.stringify(value) + '\n');
+        try {
+            const result = await nativeService.request({ ...req.body, op: 'tournament' }, writeLine);
+            writeLine({ done: true, ...result });
+        } catch (error) {
+            console.error('Error in /api/native/tournament:', error);
+            writeLine({ done: true, error: error.message });
+        }
+        return res.end();
+    }
+    try {
+        const result = await nativeService.request({ ...req.body, op: 'tournament' });
+        res.json({ success: true, ...result });
+    } catch (error) {
+        console.error('Error in /api/native/tournament:', error);
+        res.status(500).json({ success: false, error: error.message });
+    }
+});
+
+// Body: { size | rows/cols, seed, generator, ... }; the maze crosses the
+// process boundary packed (one bit per wall) rather than as a JSON grid
+app.post('/api/native/maze', async (req, res) => {
+    if (!nativeService.isAvailable()) {
+        return res.status(503).json({ success: false, error: 'Native maze service is not built' });
+    }
+    try {
+        const maze = await nativeService.request({ ...req.body, op: 'maze', format: 'packed' });
+        res.json({ success: true, ...maze });
+    } catch (error) {
+        console.error('Error in /api/native/maze:', error);
+        res.status(500).json({ success: false, error: error.message });
+    }
+});
+
+// Body: { seeds: [...], size | rows/cols (one value or one per seed),
+// players (count, one value or one per seed), generator, search, ... }.
+// Every match of the batch runs in one native call; results come back
+// packed and are returned as one array per column, with the players of
+// job j at rows first_player[j] .. first_player[j + 1] - 1.
+app.post('/api/native/batch', async (req, res) => {
+    if (!nativeService.isAvailable()) {
+        return res.status(503).json({ success: false, error: 'Native maze service is not built' });
+    }
+    if (!Array.isArray(req.body.seeds)) {
+        return res.status(400).json({ success: false, error: 'seeds must be an array' });
+    }
+    try {
+        const result = await nativeService.request({ ...req.body, op: 'batch', format: 'packed' });
+        res.json({ success: true, ...result });
+    } catch (error) {
+        console.error('Error in /api/native/batch:', error);
+        res.status(500).json({ success: false, error: error.message });
+    }
+});
+
 // --- MAZE API ENDPOINT ---
-app.post('/api/maze', (req, res) => {
+app.post('/api/maze', async (req, res) => {
     const { players, size = 10 } = req.body;
     if (!Array.isArray(players) || players.length < 2) {
         return res.status(400).json({ error: 'At least 2 players are required' });
     }
     // Generate maze
-    const maze = generateMaze(size);
+    let maze;
+    try {
+        maze = await generateMaze(size);
+    } catch (error) {
+        return res.status(500).json({ error: error.message });
+    }
     // Simulate each player with a randomized DFS path
     const results = players.map((name, idx) => {
         // Clone the maze for each player